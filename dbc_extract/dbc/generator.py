@@ -1,4 +1,4 @@
-import sys, os, re, types, HTMLParser, urllib2
+import sys, os, re, types, struct, HTMLParser, urllib2
 
 import parser, db, data, constants, json
 
@@ -982,10 +982,101 @@ class ItemDataGenerator(DataGenerator):
             s = self.generate_cpp(ids)
         elif (self._options.output_type == 'js'):
             s = self.generate_json(ids)
+        elif (self._options.output_type == 'binary'):
+            s = self.generate_binary(ids)
         else:
             s = "Unknown output type"
         return s
 
+    # Binary item data file, mapped into memory by the simulator (see
+    # dbc::init_item_data() in engine/dbc/sc_item_data.cpp). Records use the
+    # (packed) layout of struct item_data_t, so the file has to be generated
+    # with the same pointer size and byte order as the simulator build. Item
+    # names are stored as offsets into a string table following the records.
+    _binary_item_format = '=I%sIII9idddII10i10i10i10d5i5i5i5i5i3iiiiiI'
+    _binary_header_format = '=8sIIIIIIQQQ'
+
+    def generate_binary(self, ids = None):
+        ids.sort()
+
+        item_format = self._binary_item_format % (struct.calcsize('P') == 8 and 'Q' or 'I')
+        record_size = struct.calcsize(item_format)
+        name_offset = struct.calcsize('=I')
+
+        # Offset 0 is reserved for "no name"
+        strings = [ '\0' ]
+        strings_size = 1
+        records = [ ]
+
+        for id in ids + [ 0 ]:
+            item = self._item_sparse_db[id]
+            item2 = self._item_db[id]
+
+            if not item.id and id > 0:
+                sys.stderr.write('Item id %d not found\n' % id)
+                continue
+
+            # Same quest item hack as in generate_cpp
+            if item2.classs == 12:
+                item2.classs = 0
+                item2.subclass = 6
+
+            flag_types = 0x00
+
+            if hasattr(item, 'journal'):
+                if item.journal.flags_1 == 0x10:
+                    flag_types |= self._type_flags['Raid Finder']
+                elif item.journal.flags_1 == 0xC:
+                    flag_types |= self._type_flags['Heroic']
+
+            desc = self._itemnamedescription_db[item.id_name_desc]
+            flag_types |= self._type_flags.get(desc.desc, 0)
+
+            name = 0
+            if id > 0 and item.name:
+                name = strings_size
+                strings.append(item.name + '\0')
+                strings_size += len(item.name) + 1
+
+            empty = self._itemeffect_db[0]
+            spells = [ empty.id_spell ] * 5
+            trigger_types = [ empty.trigger_type ] * 5
+            cooldown_duration = [ empty.cooldown_duration ] * 5
+            cooldown_group = [ empty.cooldown_group ] * 5
+            cooldown_group_duration = [ empty.cooldown_group_duration ] * 5
+            for spell in item.spells:
+                spells[ spell.index ] = spell.id_spell
+                trigger_types[ spell.index ] = spell.trigger_type
+                cooldown_duration[ spell.index ] = spell.cooldown_duration
+                cooldown_group[ spell.index ] = spell.cooldown_group
+                cooldown_group_duration[ spell.index ] = spell.cooldown_group_duration
+
+            values = [ item.id, name, item.flags & 0xFFFFFFFF, item.flags_2 & 0xFFFFFFFF, flag_types ]
+            values += [ item.ilevel, item.req_level, item.req_skill, item.req_skill_rank, item.quality,
+                        item.inv_type, item2.classs, item2.subclass, item.bonding ]
+            values += [ float(item.delay), float(item.weapon_damage_range), float(item.item_damage_modifier) ]
+            # Same order as generate_cpp
+            values += [ item.race_mask & 0xFFFFFFFF, item.class_mask & 0xFFFFFFFF ]
+            values += [ getattr(item, 'stat_type_%d' % i) for i in xrange(1, 11) ]
+            values += [ getattr(item, 'stat_val_%d' % i) for i in xrange(1, 11) ]
+            values += [ getattr(item, 'stat_alloc_%d' % i) for i in xrange(1, 11) ]
+            values += [ float(getattr(item, 'stat_socket_mul_%d' % i)) for i in xrange(1, 11) ]
+            values += trigger_types + spells + cooldown_duration + cooldown_group + cooldown_group_duration
+            values += [ getattr(item, 'socket_color_%d' % i) for i in xrange(1, 4) ]
+            values += [ item.gem_props, item.socket_bonus, item.item_set, item.rand_suffix, item.scale_stat_dist & 0xFFFFFFFF ]
+
+            records.append(struct.pack(item_format, *values))
+
+        header_size = struct.calcsize(self._binary_header_format)
+        records_offset = header_size + (-header_size) % 8
+        strings_offset = records_offset + len(records) * record_size
+
+        header = struct.pack(self._binary_header_format, 'SCITEMDB', 1, self._options.build,
+            self._options.prefix == 'ptr' and 1 or 0, record_size, name_offset, len(records) - 1,
+            records_offset, strings_offset, strings_size)
+
+        return header + '\0' * (records_offset - header_size) + ''.join(records) + ''.join(strings)
+
     def generate_cpp(self, ids = None):
         sys.stderr.write('generate_cpp')
         ids.sort()
@@ -17,9 +17,9 @@ def parse_wow_version(option, opt, value, parser):
 
 parser = optparse.OptionParser( usage= "%prog [-otlbp] [ARGS]", version = "%prog 1.0" )
 parser.add_option("-o", "--out", dest = "output_type", 
-                  help    = "Output type (.cpp, .js) <NYI> [cpp]", metavar = "TYPE", 
+                  help    = "Output type (.cpp, .js, binary item data) <NYI> [cpp]", metavar = "TYPE", 
                   default = "cpp", action = "store", type = "choice",
-                  choices = [ 'cpp', 'js' ]), 
+                  choices = [ 'cpp', 'js', 'binary' ]), 
 parser.add_option("-t", "--type", dest = "type", 
                   help    = "Processing type [spell]", metavar = "TYPE", 
                   default = "spell", action = "store", type = "choice",
@@ -165,7 +165,10 @@ elif options.type == 'item':
         sys.exit(1)
     ids = g.filter()
     
-    print g.generate(ids)
+    if options.output_type == 'binary':
+        sys.stdout.write(g.generate(ids))
+    else:
+        print g.generate(ids)
 elif options.type == 'item_upgrade':
     g = dbc.generator.RulesetItemUpgradeGenerator(options)
     if not g.initialize():
@@ -269,6 +269,8 @@ action_t::action_t( action_e       ty,
   instant_multistrike( 1 ),
   dual(),
   callbacks( true ),
+  proc_dispatch(),
+  proc_dispatch_generation( 0 ),
   special(),
   channeled(),
   sequence(),
@@ -308,6 +310,7 @@ action_t::action_t( action_e       ty,
   base_tick_time( timespan_t::zero() ),
   dot_duration( timespan_t::zero() ),
   base_cooldown_reduction( 1.0 ),
+  dynamic_cooldown_reduction( false ),
   movement_directionality( MOVEMENT_NONE ),
   base_teleport_distance( 0.0 ),
   cost_tick_event( nullptr ),
@@ -329,6 +332,11 @@ action_t::action_t( action_e       ty,
   base_td_multiplier             = 1.0;
   base_dd_multiplier             = 1.0;
   base_multiplier                = 1.0;
+  folded_multiplier              = 1.0;
+  folded_da_multiplier           = 1.0;
+  folded_ta_multiplier           = 1.0;
+  folded_multiplier_mismatch     = false;
+  unfolded_multipliers           = false;
   base_hit                       = 0.0;
   base_crit                      = 0.0;
   rp_gain                        = 0.0;
@@ -1204,6 +1212,8 @@ void action_t::execute()
     sim -> out_log.printf( "%s performs %s (%.0f)", player -> name(), name(),
                    player -> resources.current[ player -> primary_resource() ] );
   }
+  if ( sim -> event_trace.active && ! dual )
+    sim -> event_trace.performs( *this );
 
   if ( harmful )
   {
@@ -1300,13 +1310,13 @@ void action_t::execute()
       // "On spell cast", only performed for foreground actions
       if ( ( pt2 = execute_state -> cast_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        action_callback_t::trigger( proc_callbacks( pt, pt2 ), this, execute_state );
       }
 
       // "On an execute result"
       if ( ( pt2 = execute_state -> execute_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        action_callback_t::trigger( proc_callbacks( pt, pt2 ), this, execute_state );
       }
     }
   }
@@ -1566,6 +1576,9 @@ void action_t::assess_damage( dmg_e    type,
 
   if ( ! player -> buffs.spirit_shift || ! player -> buffs.spirit_shift -> check() || ! target -> is_enemy() )
   {
+    if ( sim -> event_trace.active )
+      sim -> event_trace.damage( *this, *s, type );
+
     if ( type == DMG_DIRECT )
     {
       if ( sim -> log )
@@ -1664,7 +1677,7 @@ void action_t::assess_damage( dmg_e    type,
     proc_types pt = s -> proc_type();
     proc_types2 pt2 = s -> impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, s );
+      action_callback_t::trigger( proc_callbacks( pt, pt2 ), this, s );
   }
 
   if ( ! player -> buffs.spirit_shift || ! player -> buffs.spirit_shift -> check() )
@@ -1695,6 +1708,8 @@ void action_t::schedule_execute( action_state_t* execute_state )
   {
     sim -> out_log.printf( "%s schedules execute for %s", player -> name(), name() );
   }
+  if ( sim -> event_trace.active )
+    sim -> event_trace.schedule_execute( *this );
 
   time_to_execute = execute_time();
 
@@ -2092,6 +2107,10 @@ bool action_t::init_finished()
 {
   bool ret = true;
 
+  folded_multiplier = static_action_multiplier();
+  folded_da_multiplier = static_da_multiplier();
+  folded_ta_multiplier = static_ta_multiplier();
+
   if ( !target_if_str.empty() )
   {
     std::string::size_type offset = target_if_str.find( ':' );
@@ -2149,11 +2168,73 @@ bool action_t::init_finished()
   return ret;
 }
 
+// action_t::verify_folded_multiplier =======================================
+
+// Recompute the whole direct or tick multiplier with every static term
+// evaluated now, as it was before folding, and compare it to the folded
+// result. A term that is not actually constant (eg. it depends on a buff)
+// shows up as soon as its value differs from the one folded at init.
+
+void action_t::verify_folded_multiplier( const action_state_t* s, double folded, bool tick ) const
+{
+  if ( folded_multiplier_mismatch )
+    return;
+
+  unfolded_multipliers = true;
+  double unfolded = tick ? composite_ta_multiplier( s ) : composite_da_multiplier( s );
+  unfolded_multipliers = false;
+
+  if ( unfolded != folded )
+  {
+    folded_multiplier_mismatch = true;
+    sim -> errorf( "Player %s action %s folded %s multiplier %.6f does not match the unfolded multiplier %.6f.",
+                   player -> name(), name(), tick ? "tick" : "direct", folded, unfolded );
+  }
+}
+
 void action_t::init_target_cache()
 {
   sim -> target_non_sleeping_list.register_callback( aoe_target_list_callback_t( this ) );
 }
 
+// action_t::proc_callbacks =================================================
+
+// Callbacks of the player for the given proc types, without the ones that
+// require a different weapon. Built on first use and kept until the player
+// registers another callback.
+
+const std::vector<action_callback_t*>& action_t::proc_callbacks( proc_types pt, proc_types2 pt2 )
+{
+  const player_callbacks_t& cbs = player -> callbacks;
+  if ( proc_dispatch_generation != cbs.generation )
+  {
+    dispose( proc_dispatch.begin(), proc_dispatch.end() );
+    proc_dispatch.clear();
+    proc_dispatch_generation = cbs.generation;
+  }
+
+  unsigned key = pt * PROC2_TYPE_MAX + pt2;
+  for ( size_t i = 0, end = proc_dispatch.size(); i < end; i++ )
+  {
+    if ( proc_dispatch[ i ] -> key == key && proc_dispatch[ i ] -> weapon == weapon )
+      return proc_dispatch[ i ] -> callbacks;
+  }
+
+  proc_dispatch_t* d = new proc_dispatch_t();
+  d -> key = key;
+  d -> weapon = weapon;
+
+  const player_callbacks_t::proc_list_t& list = cbs.procs[ pt ][ pt2 ];
+  for ( size_t i = 0, end = list.size(); i < end; i++ )
+  {
+    if ( ! list[ i ] -> weapon || list[ i ] -> weapon == weapon )
+      d -> callbacks.push_back( list[ i ] );
+  }
+
+  proc_dispatch.push_back( d );
+  return d -> callbacks;
+}
+
 // action_t::reset ==========================================================
 
 void action_t::reset()
@@ -2986,10 +3067,18 @@ void action_t::snapshot_internal( action_state_t* state, unsigned flags, dmg_e r
     state -> versatility = composite_versatility( state );
 
   if ( flags & STATE_MUL_DA )
+  {
     state -> da_multiplier = composite_da_multiplier( state );
+    if ( sim -> verify_folded_multipliers )
+      verify_folded_multiplier( state, state -> da_multiplier, false );
+  }
 
   if ( flags & STATE_MUL_TA )
+  {
     state -> ta_multiplier = composite_ta_multiplier( state );
+    if ( sim -> verify_folded_multipliers )
+      verify_folded_multiplier( state, state -> ta_multiplier, true );
+  }
 
   if ( flags & STATE_MUL_PERSISTENT )
     state -> persistent_multiplier = composite_persistent_multiplier( state );
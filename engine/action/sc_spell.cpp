@@ -433,7 +433,7 @@ void heal_t::assess_damage( dmg_e heal_type,
     proc_types pt = s -> proc_type();
     proc_types2 pt2 = s -> impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, s );
+      action_callback_t::trigger( proc_callbacks( pt, pt2 ), this, s );
   }
 
   if ( player -> record_healing() )
@@ -452,81 +452,58 @@ void heal_t::assess_damage( dmg_e heal_type,
 
 player_t* heal_t::find_greatest_difference_player()
 {
-  double max = 0;
-  player_t* max_player = player;
-  for ( size_t i = 0; i < sim -> player_list.size(); ++i )
-  {
-    player_t* p = sim -> player_list[ i ];
-    // No love for pets right now
-    double diff = p -> is_pet() ? 0 : p -> resources.max[ RESOURCE_HEALTH ] - p -> resources.current[ RESOURCE_HEALTH ];
-    if ( diff > max )
-    {
-      max = diff;
-      max_player = p;
-    }
-  }
-  return max_player;
+  health_index_t& hi = sim -> health_index;
+  if ( ! hi.active )
+    hi.build( *sim );
+
+  // No love for pets right now
+  player_t* p = hi.missing.top();
+  if ( p && p -> resources.max[ RESOURCE_HEALTH ] - p -> resources.current[ RESOURCE_HEALTH ] > 0 )
+    return p;
+
+  return player;
 }
 
 // heal_t::find_lowest_player ===============================================
 
 player_t* heal_t::find_lowest_player()
 {
-  double min = 1.0;
-  player_t* max_player = player;
+  health_index_t& hi = sim -> health_index;
+  if ( ! hi.active )
+    hi.build( *sim );
 
-  for ( size_t i = 0; i < sim -> player_no_pet_list.size(); ++i ) // check players only
-  {
-    player_t* p = sim -> player_no_pet_list[ i ];
-    double hp_pct =  p -> resources.pct( RESOURCE_HEALTH );
-    if ( hp_pct < min )
-    {
-      min = hp_pct;
-      max_player = p;
-    }
-  }
+  // Players first, pets only when no player is injured
+  player_t* p = hi.players.top();
+  if ( p && p -> resources.max[ RESOURCE_HEALTH ] > 0 && p -> resources.pct( RESOURCE_HEALTH ) < 1.0 )
+    return p;
 
-  if ( min == 1.0 ) // no player found - check pets
-  {
-    for ( size_t i = 0; i < sim -> player_list.size(); ++i )
-    {
-      player_t* p = sim -> player_list[ i ];
-      if ( !p -> is_pet() ) continue;
-      double hp_pct =  p -> resources.pct( RESOURCE_HEALTH );
-      if ( hp_pct < min )
-      {
-        min = hp_pct;
-        max_player = p;
-      }
-    }
-  }
+  p = hi.pets.top();
+  if ( p && p -> resources.max[ RESOURCE_HEALTH ] > 0 && p -> resources.pct( RESOURCE_HEALTH ) < 1.0 )
+    return p;
 
-  return max_player;
+  return player;
 }
 
+// heal_t::find_lowest_players ==============================================
+
 std::vector<player_t*> heal_t::find_lowest_players( int num_players ) const
 {
-  // vector in which to store lowest N players
-  std::vector<player_t*> lowest_N_players = sim -> player_no_pet_list.data();
+  if ( static_cast< size_t >( std::max( num_players, 0 ) ) >= sim -> player_no_pet_list.size() )
+    return sim -> player_no_pet_list.data();
 
-  while ( lowest_N_players.size() > static_cast< size_t > ( num_players ) )
-  {
-    // find the remaining player with the highest health
-    double max = -1e7;
-    size_t max_player_index = 0;
-    for ( size_t i = 0; i < lowest_N_players.size(); ++i )
-    {
-      player_t* p = lowest_N_players[ i ];
-      double hp_pct = p -> resources.pct( RESOURCE_HEALTH );
-      if ( hp_pct > max )
-      {
-        max = hp_pct;
-        max_player_index = i;
-      }
-    }
-    // remove that player from lowest_N_players
-    lowest_N_players.erase( lowest_N_players.begin() + max_player_index );
-  }
+  std::vector<player_t*> lowest_N_players;
+  if ( num_players <= 0 )
+    return lowest_N_players;
+
+  health_index_t& hi = sim -> health_index;
+  if ( ! hi.active )
+    hi.build( *sim );
+
+  // On equal health the later players in the list are kept
+  hi.players_last.first( num_players, lowest_N_players );
+
+  // Callers get the players in list order, as before
+  range::sort( lowest_N_players, []( const player_t* l, const player_t* r ) { return l -> actor_index < r -> actor_index; } );
 
   return lowest_N_players;
 }
@@ -156,7 +156,9 @@ void stats_t::add_result( double act_amount,
     f -> actual_amount.add( act_amount );
     f -> total_amount.add( tot_amount );
   }
-  timeline_amount.add( sim.current_time(), act_amount );
+
+  if ( sim.timeline_resolution > 0 )
+    iteration_timeline_amount.add( sim.current_time(), act_amount );
 }
 
 // stats_t::add_execute =====================================================
@@ -211,6 +213,15 @@ void stats_t::datacollection_begin()
     direct_results_detail[ i ].datacollection_begin();
     tick_results_detail[ i ].datacollection_begin();
   }
+
+  // Size the per-iteration timeline buffer for the whole fight, so adding to it during combat
+  // never has to reallocate. Fights running longer than expected still grow it on demand.
+  if ( sim.timeline_resolution > 0 )
+  {
+    timeline_amount.set_bin_size( sim.timeline_resolution );
+    iteration_timeline_amount.set_bin_size( sim.timeline_resolution );
+    iteration_timeline_amount.init( static_cast<size_t>( sim.expected_max_time() / sim.timeline_resolution ) + 1 );
+  }
 }
 
 // stats_t::datacollection_end ==============================================
@@ -267,7 +278,8 @@ void stats_t::datacollection_end()
   num_direct_results.add( idr );
   num_tick_results.add( itr );
 
-  timeline_amount.add( sim.current_time(), 0.0 );
+  if ( sim.timeline_resolution > 0 )
+    timeline_amount.merge( iteration_timeline_amount, sim.current_time() );
 }
 
 // stats_t::analyze =========================================================
@@ -7,6 +7,14 @@
 
 namespace { // UNNAMED NAMESPACE
 
+// Position of a high priority absorb in its player's absorb_priority; absorbs
+// without one go last
+size_t absorb_rank( const absorb_buff_t& ab )
+{
+  const std::vector<unsigned>& priority = ab.player -> absorb_priority;
+  return range::find( priority, ab.data().id() ) - priority.begin();
+}
+
 struct buff_event_t : public event_t
 {
   buff_t* buff;
@@ -380,6 +388,65 @@ void buff_t::add_invalidate( cache_e c )
   }
 }
 
+// buff_t::log_stack_change =================================================
+
+void buff_t::log_stack_change( bool collect_timeline )
+{
+  stack_changes.push_back( stack_change_t( sim -> current_time(), current_stack, collect_timeline ) );
+}
+
+// buff_t::reduce_stack_changes =============================================
+
+/* Reduce the stack transitions logged during the iteration into total uptime,
+ * stack uptimes and the uptime timeline. Stack uptimes are only reduced when
+ * the report shows them, the timeline only with buff_uptime_timeline.
+ */
+void buff_t::reduce_stack_changes()
+{
+  bool collect_stack_uptime = sim -> report_details != 0;
+  int prev_stack = 0;
+  timespan_t prev_time = timespan_t::zero();
+  timespan_t span_start = timespan_t::zero();
+
+  for ( const auto& change : stack_changes )
+  {
+    if ( collect_stack_uptime && prev_stack > 0 && as<std::size_t>( prev_stack ) < stack_uptime.size() )
+      stack_uptime[ prev_stack ].add( change.time - prev_time );
+
+    if ( prev_stack == 0 && change.stack > 0 )
+    {
+      span_start = change.time;
+    }
+    else if ( prev_stack > 0 && change.stack == 0 )
+    {
+      iteration_uptime_sum += change.time - span_start;
+
+      if ( change.collect_timeline && sim -> buff_uptime_timeline )
+      {
+        timespan_t start_time = timespan_t::from_seconds( span_start.total_millis() / 1000 ) ;
+        timespan_t end_time = timespan_t::from_seconds( change.time.total_millis() / 1000 );
+        timespan_t begin_uptime = (( timespan_t::from_seconds( 1 ) - span_start ) % timespan_t::from_seconds( 1 ) );
+        timespan_t end_uptime = ( change.time % timespan_t::from_seconds( 1 ) );
+
+        if ( span_start % timespan_t::from_seconds( 1 ) == timespan_t::zero() )
+          begin_uptime = timespan_t::from_seconds( 1 );
+
+        uptime_array.add( start_time, begin_uptime.total_seconds() );
+        for ( timespan_t i = start_time + timespan_t::from_millis( 1000 ); i < end_time; i = i + timespan_t::from_millis( 1000 ) )
+          uptime_array.add( i, 1 );
+
+        if ( end_uptime != timespan_t::zero() )
+          uptime_array.add( end_time, end_uptime.total_seconds() );
+      }
+    }
+
+    prev_stack = change.stack;
+    prev_time = change.time;
+  }
+
+  stack_changes.clear();
+}
+
 // buff_t::datacollection_begin =============================================
 
 void buff_t::datacollection_begin()
@@ -395,6 +462,10 @@ void buff_t::datacollection_begin()
 
   for ( int i = 0; i <= simulation_max_stack; i++ )
     stack_uptime[ i ].datacollection_begin();
+
+  stack_changes.clear();
+  if ( current_stack > 0 )
+    log_stack_change();
 }
 
 // buff_t::datacollection_end ===============================================
@@ -403,6 +474,8 @@ void buff_t::datacollection_end()
 {
   timespan_t time = player ? player -> iteration_fight_length : sim -> current_time();
 
+  reduce_stack_changes();
+
   uptime_pct.add( time != timespan_t::zero() ? 100.0 * iteration_uptime_sum / time : 0 );
 
   for ( int i = 0; i <= simulation_max_stack; i++ )
@@ -691,19 +764,14 @@ void buff_t::decrement( int    stacks,
   {
     if ( requires_invalidation ) invalidate_cache();
 
-    if ( as<std::size_t>( current_stack ) < stack_uptime.size() )
-      stack_uptime[ current_stack ].update( false, sim -> current_time() );
-
     current_stack -= stacks;
+    log_stack_change();
 
     if ( value == DEFAULT_VALUE() && default_value != DEFAULT_VALUE() )
       value = default_value;
 
     if ( value >= 0 ) current_value = value;
 
-    if ( as<std::size_t>( current_stack ) < stack_uptime.size() )
-      stack_uptime[ current_stack ].update( true, sim -> current_time() );
-
     if ( sim -> debug )
       sim -> out_debug.printf( "buff %s decremented by %d to %d stacks",
                      name_str.c_str(), stacks, current_stack );
@@ -895,6 +963,7 @@ void buff_t::bump( int stacks, double value )
   if ( max_stack() < 0 )
   {
     current_stack += stacks;
+    log_stack_change();
   }
   else if ( current_stack < max_stack() )
   {
@@ -909,10 +978,7 @@ void buff_t::bump( int stacks, double value )
     }
 
     if ( before_stack != current_stack )
-    {
-      stack_uptime[ before_stack ].update( false, sim -> current_time() );
-      stack_uptime[ current_stack ].update( true, sim -> current_time() );
-    }
+      log_stack_change();
 
     aura_gain();
 
@@ -1009,7 +1075,6 @@ void buff_t::expire( timespan_t delay )
   event_t::cancel( tick_event );
 
   assert( as<std::size_t>( current_stack ) < stack_uptime.size() );
-  stack_uptime[ current_stack ].update( false, sim -> current_time() );
 
   if ( player && change_regen_rate )
     player -> do_dynamic_regen();
@@ -1033,28 +1098,8 @@ void buff_t::expire( timespan_t delay )
   }
 
   current_stack = 0;
+  log_stack_change( ! constant && ! overridden );
   if ( requires_invalidation ) invalidate_cache();
-  if ( last_start >= timespan_t::zero() )
-  {
-    iteration_uptime_sum += sim -> current_time() - last_start;
-    if ( ! constant && ! overridden && sim -> buff_uptime_timeline )
-    {
-      timespan_t start_time = timespan_t::from_seconds( last_start.total_millis() / 1000 ) ;
-      timespan_t end_time = timespan_t::from_seconds( sim -> current_time().total_millis() / 1000 );
-      timespan_t begin_uptime = (( timespan_t::from_seconds( 1 ) - last_start ) % timespan_t::from_seconds( 1 ) );
-      timespan_t end_uptime = (sim -> current_time() % timespan_t::from_seconds( 1 ));
-
-      if ( last_start % timespan_t::from_seconds( 1 ) == timespan_t::zero() )
-        begin_uptime = timespan_t::from_seconds( 1 );
-
-      uptime_array.add( start_time, begin_uptime.total_seconds() );
-      for ( timespan_t i = start_time + timespan_t::from_millis( 1000 ); i < end_time; i = i + timespan_t::from_millis( 1000 ) )
-        uptime_array.add( i, 1 );
-
-      if ( end_uptime != timespan_t::zero() )
-        uptime_array.add( end_time, end_uptime.total_seconds() );
-    }
-  }
 
   if ( sim -> target -> resources.base[ RESOURCE_HEALTH ] == 0 ||
        sim -> target -> resources.current[ RESOURCE_HEALTH ] > 0 )
@@ -1090,6 +1135,9 @@ void buff_t::predict()
 
 void buff_t::aura_gain()
 {
+  if ( sim -> event_trace.active && ( ! player || ! player -> is_sleeping() ) )
+    sim -> event_trace.buff_gain( *this );
+
   if ( sim -> log )
   {
     std::string s = name_str + "_" + util::to_string( current_stack );
@@ -1113,6 +1161,9 @@ void buff_t::aura_gain()
 
 void buff_t::aura_loss()
 {
+  if ( sim -> event_trace.active && ( ! player || ! player -> is_sleeping() ) )
+    sim -> event_trace.buff_loss( *this );
+
   if ( player )
   {
     if ( sim -> log && ! player -> is_sleeping() )
@@ -1566,9 +1617,6 @@ void stat_buff_t::decrement( int stacks, double /* value */ )
   }
   else
   {
-    if ( as<std::size_t>( current_stack ) < stack_uptime.size() )
-      stack_uptime[ current_stack ].update( false, sim -> current_time() );
-
     for ( size_t i = 0; i < stats.size(); ++i )
     {
       double delta = stats[ i ].amount * stacks;
@@ -1579,12 +1627,10 @@ void stat_buff_t::decrement( int stacks, double /* value */ )
       stats[ i ].current_value -= delta;
     }
     current_stack -= stacks;
+    log_stack_change();
 
     invalidate_cache();
 
-    if ( as<std::size_t>( current_stack ) < stack_uptime.size() )
-      stack_uptime[ current_stack ].update( true, sim -> current_time() );
-
     if ( sim -> debug )
       sim -> out_debug.printf( "buff %s decremented by %d to %d stacks",
                      name_str.c_str(), stacks, current_stack );
@@ -1813,7 +1859,17 @@ void absorb_buff_t::start( int stacks, double value, timespan_t duration )
   assert( range::find( player -> absorb_buff_list, this ) == player -> absorb_buff_list.end()
           && "Attempting to add absorb buff to absorb_buffs list twice" );
 
-  player -> absorb_buff_list.push_back( this );
+  // High priority absorbs lead the list in absorb_priority order, after any
+  // active absorb of the same priority
+  auto it = player -> absorb_buff_list.end();
+  if ( high_priority )
+  {
+    size_t rank = absorb_rank( *this );
+    it = range::find_if( player -> absorb_buff_list, [ rank ]( const absorb_buff_t* ab ) {
+      return ! ab -> high_priority || absorb_rank( *ab ) > rank;
+    } );
+  }
+  player -> absorb_buff_list.insert( it, this );
 }
 
 void absorb_buff_t::expire_override( int expiration_stacks, timespan_t remaining_duration )
@@ -1965,6 +1965,13 @@ struct ghoul_pet_t : public death_knight_pet_t
         am *= 1.0 + dtb;
       }
 
+      return am;
+    }
+
+    virtual double static_action_multiplier() const override
+    {
+      double am = melee_attack_t::static_action_multiplier();
+
       am *= 0.8;
 
       return am;
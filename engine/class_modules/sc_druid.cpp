@@ -1139,6 +1139,7 @@ namespace pets {
 
         // Casts have a delay that decreases with haste. This is a very rough approximation.
         cooldown -> duration = timespan_t::from_millis( 600 );
+        dynamic_cooldown_reduction = true;
       }
 
       double cooldown_reduction() const override
@@ -1629,6 +1630,7 @@ struct berserk_buff_t : public druid_buff_t<buff_t>
 
     if ( druid.perk.enhanced_berserk -> ok() )
     {
+      player -> sample_timelines();
       player -> resources.max[ RESOURCE_ENERGY ] -= druid.perk.enhanced_berserk -> effectN( 1 ).base_value();
       // Force energy down to cap if it's higher.
       player -> resources.current[ RESOURCE_ENERGY ] = std::min( player -> resources.current[ RESOURCE_ENERGY ], player -> resources.max[ RESOURCE_ENERGY ]);
@@ -3196,7 +3198,9 @@ public:
                  const spell_data_t* s = spell_data_t::nil() ) :
     base_t( n, p, s ), rage_amount( 0.0 ), 
     rage_tick_amount( 0.0 ),  rage_gain( p -> get_gain( name() ) )
-  {}
+  {
+    dynamic_cooldown_reduction = true;
+  }
 
   virtual timespan_t gcd() const override
   {
@@ -3926,6 +3930,16 @@ struct healing_touch_t : public druid_heal_t
   {
     double adm = base_t::action_da_multiplier();
 
+    if ( p() -> spell.moonkin_form -> ok() && target == p() )
+      adm *= 1.0 + 0.50; // Not in spell data
+
+    return adm;
+  }
+
+  virtual double static_da_multiplier() const override
+  {
+    double adm = base_t::static_da_multiplier();
+
     if ( p() -> talent.dream_of_cenarius -> ok() ) {
       if ( p() -> specialization() == DRUID_FERAL || p() -> specialization() == DRUID_BALANCE )
         adm *= 1.0 + p() -> talent.dream_of_cenarius -> effectN( 1 ).percent();
@@ -3933,9 +3947,6 @@ struct healing_touch_t : public druid_heal_t
         adm *= 1.0 + p() -> talent.dream_of_cenarius -> effectN( 2 ).percent();
     }
 
-    if ( p() -> spell.moonkin_form -> ok() && target == p() )
-      adm *= 1.0 + 0.50; // Not in spell data
-
     return adm;
   }
 
@@ -4172,9 +4183,9 @@ struct rejuvenation_t : public druid_heal_t
       p() -> buff.bear_form -> expire();
   }
 
-  virtual double action_ta_multiplier() const override
+  virtual double static_ta_multiplier() const override
   {
-    double atm = base_t::action_ta_multiplier();
+    double atm = base_t::static_ta_multiplier();
 
     if ( p() -> talent.dream_of_cenarius -> ok() && p() -> specialization() == DRUID_FERAL )
         atm *= 1.0 + p() -> talent.dream_of_cenarius -> effectN( 2 ).percent();
@@ -5375,6 +5386,8 @@ public:
     // Hard code charge information since it isn't in the spell data.
     cooldown -> duration = timespan_t::from_seconds( 12.0 );
     cooldown -> charges = 2;
+    // Guardian of Elune reduces the recharge time by dodge chance
+    dynamic_cooldown_reduction = p -> talent.guardian_of_elune -> ok();
 
     use_off_gcd = true;
     harmful = false;
@@ -5906,13 +5919,8 @@ struct wrath_t : public druid_spell_t
   {
     double m = druid_spell_t::action_multiplier();
 
-    m *= 1.0 + p() -> sets.set( SET_CASTER, T13, B2 ) -> effectN( 1 ).percent();
-
     m *= 1.0 + p() -> buff.heart_of_the_wild -> damage_spell_multiplier();
 
-    if ( p() -> talent.dream_of_cenarius && p() -> specialization() == DRUID_RESTORATION )
-      m *= 1.0 + p() -> talent.dream_of_cenarius -> effectN( 1 ).percent();
-
     if ( p() -> buff.solar_empowerment -> up() )
       m *= 1.0 + p() -> buff.solar_empowerment -> data().effectN( 1 ).percent() +
                  p() -> talent.soul_of_the_forest -> effectN( 1 ).percent();
@@ -5920,6 +5928,18 @@ struct wrath_t : public druid_spell_t
     return m;
   }
 
+  double static_action_multiplier() const override
+  {
+    double m = druid_spell_t::static_action_multiplier();
+
+    m *= 1.0 + p() -> sets.set( SET_CASTER, T13, B2 ) -> effectN( 1 ).percent();
+
+    if ( p() -> talent.dream_of_cenarius && p() -> specialization() == DRUID_RESTORATION )
+      m *= 1.0 + p() -> talent.dream_of_cenarius -> effectN( 1 ).percent();
+
+    return m;
+  }
+
   timespan_t execute_time() const override
   {
     timespan_t casttime = druid_spell_t::execute_time();
@@ -5986,7 +6006,7 @@ void druid_t::trigger_shooting_stars( action_state_t* s )
   {
     if ( rng().roll( spec.shooting_stars -> effectN( 1 ).percent() * 2 ) )
     {
-      if ( cooldown.starfallsurge -> current_charge == 3 )
+      if ( cooldown.starfallsurge -> available_charges() == 3 )
         proc.shooting_stars_wasted -> occur();
       cooldown.starfallsurge -> reset( true );
       proc.shooting_stars -> occur();
@@ -5994,7 +6014,7 @@ void druid_t::trigger_shooting_stars( action_state_t* s )
   }
   else if ( rng().roll( spec.shooting_stars -> effectN( 1 ).percent() ) )
   {
-    if ( cooldown.starfallsurge -> current_charge == 3 )
+    if ( cooldown.starfallsurge -> available_charges() == 3 )
       proc.shooting_stars_wasted -> occur();
     cooldown.starfallsurge -> reset( true );
     proc.shooting_stars -> occur();
@@ -8022,6 +8042,7 @@ void druid_t::balance_tracker()
 
   eclipse_amount = 105 * sin( 2 * M_PI * balance_time / timespan_t::from_millis( 40000 ) ); // Re-calculate eclipse
 
+  sample_timelines();
   resources.current[ RESOURCE_ECLIPSE ] = eclipse_amount;
 
   if ( eclipse_amount >= 100 )
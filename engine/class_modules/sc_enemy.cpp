@@ -1151,6 +1151,10 @@ void enemy_t::init_base_stats()
   {
     initial_health = static_cast<double>( sim -> overrides.target_health[ enemy_id % sim -> overrides.target_health.size() ] );
   }
+  else if ( fixed_health == 0 && enemy_id < sim -> calibrated_health.size() )
+  {
+    initial_health = sim -> calibrated_health[ enemy_id ];
+  }
   else
   {
     initial_health = fixed_health;
@@ -1490,8 +1494,13 @@ void enemy_t::recalculate_health()
   }
   else
   {
+    // Iterations of the calibration phase count towards the dampening once the calibrated health is in use
+    int n = sim -> current_iteration + 1;
+    if ( ! sim -> calibrating_health && ! sim -> calibrated_health.empty() )
+      n += sim -> health_calibration_iterations;
+
     timespan_t delta_time = sim -> current_time() - sim -> expected_iteration_time;
-    delta_time /= std::pow( ( sim -> current_iteration + 1 ), health_recalculation_dampening_exponent ); // dampening factor, by default 1/n
+    delta_time /= std::pow( n, health_recalculation_dampening_exponent ); // dampening factor, by default 1/n
     double factor = 1.0 - ( delta_time / sim -> expected_iteration_time );
 
     if ( factor > 1.5 ) factor = 1.5;
@@ -1503,6 +1512,13 @@ void enemy_t::recalculate_health()
     initial_health *= factor;
   }
 
+  if ( sim -> calibrating_health )
+  {
+    if ( sim -> calibrated_health.size() <= enemy_id )
+      sim -> calibrated_health.resize( enemy_id + 1 );
+    sim -> calibrated_health[ enemy_id ] = initial_health;
+  }
+
   if ( sim -> debug ) sim -> out_debug.printf( "Target %s initial health calculated to be %.0f. Damage was %.0f", name(), initial_health, iteration_dmg_taken );
 }
 
@@ -1613,7 +1629,8 @@ void enemy_t::demise()
 {
   if ( this == sim -> target )
   {
-    if ( sim -> current_iteration != 0 || sim -> overrides.target_health.size() > 0 || fixed_health > 0 )
+    if ( sim -> current_iteration != 0 || sim -> overrides.target_health.size() > 0 || fixed_health > 0 ||
+         ( ! sim -> calibrating_health && ! sim -> calibrated_health.empty() ) )
       // For the main target, end simulation on death.
       sim -> cancel_iteration();
   }
@@ -488,9 +488,9 @@ public:
     return p() -> get_target_data( t );
   }
 
-  virtual double action_multiplier() const
+  virtual double static_action_multiplier() const
   {
-    double am = ab::action_multiplier();
+    double am = ab::static_action_multiplier();
 
     if ( lone_wolf )
       am *= 1.0 + p() -> talents.lone_wolf -> effectN( 1 ).percent();
@@ -2452,9 +2452,9 @@ struct powershot_t: public hunter_ranged_attack_t
     base_aoe_multiplier *= 0.5;
   }
 
-  virtual double action_multiplier() const override
+  virtual double static_action_multiplier() const override
   {
-    double am = hunter_ranged_attack_t::action_multiplier();
+    double am = hunter_ranged_attack_t::static_action_multiplier();
     // for primary target
     am *= 2.0;  // from the tooltip
     return am;
@@ -2675,9 +2675,9 @@ struct chimaera_shot_impact_t: public hunter_ranged_attack_t
     }
   }
 
-  double action_multiplier() const override
+  double static_action_multiplier() const override
   {
-    double am = hunter_ranged_attack_t::action_multiplier();
+    double am = hunter_ranged_attack_t::static_action_multiplier();
     am *= 1.0 + p() -> sets.set( SET_MELEE, T14, B2 ) -> effectN( 2 ).percent();
 
     return am;
@@ -2859,9 +2859,9 @@ struct explosive_shot_t: public hunter_ranged_attack_t
     hunter_ranged_attack_t::update_ready( cd_duration );
   }
 
-  double action_multiplier() const override
+  double static_action_multiplier() const override
   {
-    double am = hunter_ranged_attack_t::action_multiplier();
+    double am = hunter_ranged_attack_t::static_action_multiplier();
     am *= 1.0 + p() -> sets.set( SET_MELEE, T14, B2 ) -> effectN( 3 ).percent();
     return am;
   }
@@ -4137,7 +4137,8 @@ void hunter_t::create_buffs()
                                                                 .add_invalidate( CACHE_ATTACK_POWER ));
 
   buffs.thrill_of_the_hunt          = buff_creator_t( this, 34720, "thrill_of_the_hunt" ).chance( talents.thrill_of_the_hunt -> proc_chance() );
-  buffs.steady_focus                = buff_creator_t( this, 177668, "steady_focus" ).chance( talents.steady_focus -> ok() );
+  buffs.steady_focus                = buff_creator_t( this, 177668, "steady_focus" ).chance( talents.steady_focus -> ok() )
+                                      .affects_regen( true );
   buffs.pre_steady_focus            = buff_creator_t( this, "pre_steady_focus" ).max_stack( 2 ).quiet( true );
 
   buffs.lock_and_load               = buff_creator_t( this, 168980, "lock_and_load" );
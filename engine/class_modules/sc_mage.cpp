@@ -2165,6 +2165,14 @@ struct arcane_missiles_t : public mage_spell_t
                 p() -> spec.arcane_charge -> effectN( 1 ).percent() *
                 ( 1.0 + p() -> sets.set( SET_CASTER, T15, B4 )
                             -> effectN( 1 ).percent() );
+
+    return am;
+  }
+
+  virtual double static_action_multiplier() const override
+  {
+    double am = mage_spell_t::static_action_multiplier();
+
     if ( p() -> sets.has_set_bonus( SET_CASTER, T14, B2 ) )
     {
       am *= 1.07;
@@ -2708,15 +2716,22 @@ struct cone_of_cold_t : public mage_spell_t
     p() -> buffs.frozen_thoughts -> expire();
   }
 
-  virtual double action_multiplier() const override
+  virtual double static_action_multiplier() const override
   {
-    double am = mage_spell_t::action_multiplier();
+    double am = mage_spell_t::static_action_multiplier();
 
     if ( p() -> glyphs.cone_of_cold -> ok() )
     {
       am *=  1.0 + p() -> glyphs.cone_of_cold -> effectN( 1 ).percent();
     }
 
+    return am;
+  }
+
+  virtual double action_multiplier() const override
+  {
+    double am = mage_spell_t::action_multiplier();
+
     if ( p() -> buffs.frozen_thoughts -> up() )
     {
       am *= ( 1.0 + p() -> buffs.frozen_thoughts -> data().effectN( 1 ).percent() );
@@ -2759,9 +2774,9 @@ struct dragons_breath_t : public mage_spell_t
     aoe = -1;
   }
 
-  virtual double action_multiplier() const override
+  virtual double static_action_multiplier() const override
   {
-    double am = mage_spell_t::action_multiplier();
+    double am = mage_spell_t::static_action_multiplier();
 
     if ( p() -> glyphs.dragons_breath -> ok() )
     {
@@ -3619,11 +3634,6 @@ struct ice_lance_t : public mage_spell_t
       am *= 1.0 + p() -> buffs.fingers_of_frost -> data().effectN( 2 ).percent();
     }
 
-    if ( p() -> sets.has_set_bonus( SET_CASTER, T14, B2 ) )
-    {
-      am *= 1.12;
-    }
-
     if ( p() -> buffs.frozen_thoughts -> up() )
     {
       am *= ( 1.0 + p() -> buffs.frozen_thoughts -> data().effectN( 1 ).percent() );
@@ -3636,6 +3646,18 @@ struct ice_lance_t : public mage_spell_t
 
     return am;
   }
+
+  virtual double static_action_multiplier() const override
+  {
+    double am = mage_spell_t::static_action_multiplier();
+
+    if ( p() -> sets.has_set_bonus( SET_CASTER, T14, B2 ) )
+    {
+      am *= 1.12;
+    }
+
+    return am;
+  }
 };
 
 // Ice Nova Spell ==========================================================
@@ -2434,9 +2434,9 @@ struct rising_sun_kick_t: public monk_melee_attack_t
       rsk_proc = new rising_sun_kick_proc_t( p, p -> spec.rising_sun_kick_trinket );
   }
 
-  virtual double action_multiplier() const
+  virtual double static_action_multiplier() const
   {
-    double am = monk_melee_attack_t::action_multiplier();
+    double am = monk_melee_attack_t::static_action_multiplier();
 
     if ( p() -> talent.pool_of_mists -> ok() )
       am *= 1.0 + p() -> talent.pool_of_mists -> effectN( 4 ).percent();
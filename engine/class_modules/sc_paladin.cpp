@@ -1378,9 +1378,9 @@ struct consecration_t : public paladin_spell_t
     }
   }
 
-  virtual double action_ta_multiplier() const override
+  virtual double static_ta_multiplier() const override
   {
-    double am = paladin_spell_t::action_ta_multiplier();
+    double am = paladin_spell_t::static_ta_multiplier();
 
     am *= 1.0 + p() -> perk.improved_consecration -> effectN( 1 ).percent();
 
@@ -1657,6 +1657,13 @@ struct eternal_flame_hot_t : public paladin_heal_t
       am *= 1.0 + p() -> talents.eternal_flame -> effectN( 2 ).percent();
     }
 
+    return am;
+  }
+
+  virtual double static_ta_multiplier() const override
+  {
+    double am = paladin_heal_t::static_ta_multiplier();
+
     // Holy Insight buffs all healing by 25% & WoG/EF/LoD by 50%.
     // The 25% buff is already in paladin_heal_t, so we need to divide by that first & then apply 50%
     am /= 1.0 + p() -> passives.holy_insight -> effectN( 6 ).percent();
@@ -3164,9 +3171,6 @@ struct word_of_glory_t : public paladin_heal_t
     // scale the am by holy power spent, can't be more than 3 and Divine Purpose counts as 3
     am *= ( ( p() -> holy_power_stacks() <= 3  && c > 0.0 ) ? p() -> holy_power_stacks() : 3 ) / 3.0;
 
-    // T14 protection 4-piece bonus
-    am *= ( 1.0 + p() -> sets.set( SET_TANK, T14, B4 ) -> effectN( 1 ).percent() );
-
     if ( p() -> buffs.bastion_of_glory -> up() )
     {
       // grant extra healing per stack of BoG; can't expire() BoG here because it's needed in execute()
@@ -3180,6 +3184,16 @@ struct word_of_glory_t : public paladin_heal_t
     return am;
   }
 
+  virtual double static_action_multiplier() const override
+  {
+    double am = paladin_heal_t::static_action_multiplier();
+
+    // T14 protection 4-piece bonus
+    am *= ( 1.0 + p() -> sets.set( SET_TANK, T14, B4 ) -> effectN( 1 ).percent() );
+
+    return am;
+  }
+
   virtual void execute() override
   {
     double hopo = ( ( p() -> holy_power_stacks() <= 3  && cost() > 0.0 ) ? p() -> holy_power_stacks() : 3 );
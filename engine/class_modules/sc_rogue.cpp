@@ -1607,9 +1607,9 @@ struct ambush_t : public rogue_attack_t
     }
   }
 
-  double action_multiplier() const override
+  double static_action_multiplier() const override
   {
-    double m = rogue_attack_t::action_multiplier();
+    double m = rogue_attack_t::static_action_multiplier();
 
     if ( weapon -> type == WEAPON_DAGGER )
       m *= 1.40;
@@ -2288,9 +2288,9 @@ struct hemorrhage_t : public rogue_attack_t
     initialize_sinister_calling( 168908 );
   }
 
-  double action_da_multiplier() const override
+  double static_da_multiplier() const override
   {
-    double m = rogue_attack_t::action_da_multiplier();
+    double m = rogue_attack_t::static_da_multiplier();
 
     if ( weapon -> type == WEAPON_DAGGER )
       m *= 1.4;
@@ -2575,6 +2575,7 @@ struct premeditation_t : public rogue_attack_t
     {
       rogue_t* p = static_cast< rogue_t* >( player() );
 
+      p -> sample_timelines();
       p -> resources.current[ RESOURCE_COMBO_POINT ] -= combo_points;
       if ( sim().log )
       {
@@ -640,6 +640,7 @@ public:
     cd_wasted_exec( nullptr ), cd_wasted_cumulative( nullptr ), cd_wasted_iter( nullptr )
   {
     ab::may_crit = true;
+    ab::dynamic_cooldown_reduction = hasted_cd;
   }
 
   void init()
@@ -721,7 +722,7 @@ public:
   {
     if ( cd_wasted_exec &&
          ( cd > timespan_t::zero() || ( cd <= timespan_t::zero() && ab::cooldown -> duration > timespan_t::zero() ) ) &&
-         ab::cooldown -> current_charge == ab::cooldown -> charges &&
+         ab::cooldown -> available_charges() == ab::cooldown -> charges &&
          ab::cooldown -> last_charged > timespan_t::zero() &&
          ab::cooldown -> last_charged < ab::sim -> current_time() )
     {
@@ -78,11 +78,11 @@ public:
     pet_t* last;
     static const int WILD_IMP_LIMIT = 25;
     static const int T18_PET_LIMIT = 6 ;
-    std::array<pets::wild_imp_pet_t*, WILD_IMP_LIMIT> wild_imps;
+    pet_pool_t wild_imps;
     pet_t* inner_demon;
-    std::array<pets::t18_illidari_satyr_t*, T18_PET_LIMIT> t18_illidari_satyr;
-    std::array<pets::t18_prince_malchezaar_t*, T18_PET_LIMIT> t18_prince_malchezaar;
-    std::array<pets::t18_vicious_hellhound_t*, T18_PET_LIMIT> t18_vicious_hellhound;
+    pet_pool_t t18_illidari_satyr;
+    pet_pool_t t18_prince_malchezaar;
+    pet_pool_t t18_vicious_hellhound;
   } pets;
 
   std::vector<std::string> pet_name_list;
@@ -1281,8 +1281,6 @@ struct t18_illidari_satyr_t: public warlock_pet_t
     warlock_pet_t::init_base_stats();
     base_energy_regen_per_second = 0;
     melee_attack = new actions::warlock_pet_melee_t( this );
-    if ( o() -> pets.t18_illidari_satyr[0] )
-      melee_attack -> stats = o() -> pets.t18_illidari_satyr[0] -> get_stats( "melee" );
   }
 };
 
@@ -1301,8 +1299,6 @@ struct t18_prince_malchezaar_t: public warlock_pet_t
     warlock_pet_t::init_base_stats();
     base_energy_regen_per_second = 0;
     melee_attack = new actions::warlock_pet_melee_t( this );
-    if ( o() -> pets.t18_prince_malchezaar[0] )
-      melee_attack -> stats = o() -> pets.t18_prince_malchezaar[0] -> get_stats( "melee" );
   }
 
   double composite_player_multiplier( school_e school ) const override
@@ -1330,8 +1326,6 @@ struct t18_vicious_hellhound_t: public warlock_pet_t
     main_hand_weapon.swing_time = timespan_t::from_seconds( 1.0 );
     melee_attack = new actions::warlock_pet_melee_t( this );
     melee_attack -> base_execute_time = timespan_t::from_seconds( 1.0 );
-    if ( o() -> pets.t18_vicious_hellhound[0] )
-      melee_attack -> stats = o() -> pets.t18_vicious_hellhound[0] -> get_stats( "melee" );
   }
 };
 
@@ -1490,17 +1484,10 @@ struct wild_imp_pet_t: public warlock_pet_t
     {
       action_t* a = new actions::wild_firebolt_t( this );
       firebolt_stats = &( a -> stats );
-      if ( this == o() -> pets.wild_imps[ 0 ] || sim -> report_pets_separately )
-      {
-        regular_stats = a -> stats;
-        swarm_stats = get_stats( "fel_firebolt_swarm", a );
-        swarm_stats -> school = a -> school;
-      }
-      else
-      {
-        regular_stats = o() -> pets.wild_imps[ 0 ] -> get_stats( "fel_firebolt" );
-        swarm_stats = o() -> pets.wild_imps[ 0 ] -> get_stats( "fel_firebolt_swarm" );
-      }
+      // Pooled instances get the prototype's stats
+      regular_stats = a -> stats;
+      swarm_stats = get_stats( "fel_firebolt_swarm", a );
+      swarm_stats -> school = a -> school;
       return a;
     }
 
@@ -2319,17 +2306,13 @@ public:
 
   static void trigger_wild_imp( warlock_t* p )
   {
-    for ( size_t i = 0; i < p -> pets.wild_imps.size() ; i++ )
+    if ( pet_t* imp = p -> pets.wild_imps.request() )
     {
-      if ( p -> pets.wild_imps[i] -> is_sleeping() )
-      {
-        p -> pets.wild_imps[i] -> trigger();
-        p -> procs.wild_imp -> occur();
-        return;
-      }
+      debug_cast<pets::wild_imp_pet_t*>( imp ) -> trigger();
+      p -> procs.wild_imp -> occur();
+      return;
     }
     p -> sim -> errorf( "Player %s ran out of wild imps.\n", p -> name() );
-    assert( false ); // Will only get here if there are no available imps
   }
 };
 
@@ -2844,7 +2827,7 @@ struct corruption_t: public warlock_spell_t
 
     if ( p() -> sets.has_set_bonus( WARLOCK_DEMONOLOGY, T17, B4 )
         && rng().roll( p() -> sets.set( WARLOCK_DEMONOLOGY, T17, B4 ) -> effectN( 2 ).percent() )
-        && ( p() -> cooldowns.hand_of_guldan -> current_charge < p() -> cooldowns.hand_of_guldan -> charges ))
+        && ( p() -> cooldowns.hand_of_guldan -> available_charges() < p() -> cooldowns.hand_of_guldan -> charges ))
     {
         p() -> cooldowns.hand_of_guldan -> adjust( -p() -> cooldowns.hand_of_guldan -> duration); //decrease remaining time by the duration of one charge, i.e., add one charge
     }
@@ -2933,9 +2916,9 @@ struct drain_life_t: public warlock_spell_t
     trigger_seed_of_corruption( td( d -> state -> target ), p(), d -> state -> result_amount );
   }
 
-  virtual double action_multiplier() const override
+  virtual double static_action_multiplier() const override
   {
-    double am = warlock_spell_t::action_multiplier();
+    double am = warlock_spell_t::static_action_multiplier();
 
     if ( p() -> talents.harvest_life -> ok() )
       am *= 1.0 + p() -> talents.harvest_life -> effectN( 1 ).percent();
@@ -4040,8 +4023,6 @@ struct drain_soul_t: public warlock_spell_t
   {
     double m = warlock_spell_t::action_multiplier();
 
-    m *= 1.0 + p() -> sets.set( SET_CASTER, T15, B4 ) -> effectN( 1 ).percent();
-
     m *= 1.0 + p() -> talents.grimoire_of_sacrifice -> effectN( 4 ).percent() * p() -> buffs.grimoire_of_sacrifice -> stack();
 
     if ( p() ->  buffs.tier16_2pc_empowered_grasp -> up() )
@@ -4051,6 +4032,15 @@ struct drain_soul_t: public warlock_spell_t
     return m;
   }
 
+  virtual double static_action_multiplier() const override
+  {
+    double m = warlock_spell_t::static_action_multiplier();
+
+    m *= 1.0 + p() -> sets.set( SET_CASTER, T15, B4 ) -> effectN( 1 ).percent();
+
+    return m;
+  }
+
   virtual void tick( dot_t* d ) override
   {
     warlock_spell_t::tick( d );
@@ -4195,18 +4185,16 @@ struct imp_swarm_t: public warlock_spell_t
     p() -> demonic_calling_event = new ( *sim ) warlock_t::demonic_calling_event_t( player, cooldown -> duration, true );
 
     int imp_count = data().effectN( 1 ).base_value();
-    int j = 0;
-
-    for ( size_t i = 0; i < p() -> pets.wild_imps.size(); i++ )
+    for ( int j = 0; j < imp_count; j++ )
     {
-      if ( p() -> pets.wild_imps[i] -> is_sleeping() )
+      pet_t* imp = p() -> pets.wild_imps.request();
+      if ( ! imp )
       {
-        p() -> pets.wild_imps[i] -> trigger( true );
-        if ( ++j == imp_count ) break;
+        sim -> errorf( "Player %s ran out of wild imps during imp_swarm.\n", p() -> name() );
+        break;
       }
+      debug_cast<pets::wild_imp_pet_t*>( imp ) -> trigger( true );
     }
-    if ( j != imp_count ) sim -> errorf( "Player %s ran out of wild imps during imp_swarm.\n", p() -> name() );
-    assert( j == imp_count );  // Assert fails if we didn't have enough available wild imps
   }
 };
 
@@ -5585,25 +5573,23 @@ void warlock_t::create_pets()
 
   if ( specialization() == WARLOCK_DEMONOLOGY )
   {
-    for ( size_t i = 0; i < pets.wild_imps.size(); i++ )
+    for ( int i = 0; i < pets_t::WILD_IMP_LIMIT; i++ )
     {
-      pets.wild_imps[ i ] = new pets::wild_imp_pet_t( sim, this );
-      if ( i > 0 )
-        pets.wild_imps[ i ] -> quiet = 1;
+      pets.wild_imps.add( new pets::wild_imp_pet_t( sim, this ) );
     }
     if ( sets.has_set_bonus( WARLOCK_DEMONOLOGY, T18, B4 ) )
     {
-      for ( size_t i = 0; i < pets.t18_illidari_satyr.size(); i++ )
+      for ( int i = 0; i < pets_t::T18_PET_LIMIT; i++ )
       {
-        pets.t18_illidari_satyr[i] = new pets::t18_illidari_satyr_t( sim, this );
+        pets.t18_illidari_satyr.add( new pets::t18_illidari_satyr_t( sim, this ) );
       }
-      for ( size_t i = 0; i < pets.t18_prince_malchezaar.size(); i++ )
+      for ( int i = 0; i < pets_t::T18_PET_LIMIT; i++ )
       {
-        pets.t18_prince_malchezaar[i] = new pets::t18_prince_malchezaar_t( sim, this );
+        pets.t18_prince_malchezaar.add( new pets::t18_prince_malchezaar_t( sim, this ) );
       }
-      for ( size_t i = 0; i < pets.t18_vicious_hellhound.size(); i++ )
+      for ( int i = 0; i < pets_t::T18_PET_LIMIT; i++ )
       {
-        pets.t18_vicious_hellhound[i] = new pets::t18_vicious_hellhound_t( sim, this );
+        pets.t18_vicious_hellhound.add( new pets::t18_vicious_hellhound_t( sim, this ) );
       }
     }
 
@@ -5834,26 +5820,18 @@ struct molten_core_t : public buff_t
       double pet = rng().range( 0.0, 1.0 );
       if ( pet <= 0.6 ) // 45% chance to spawn hellhound
       {
-        for ( size_t i = 0; i < p -> pets.t18_vicious_hellhound.size(); i++ )
+        if ( pet_t* demon = p -> pets.t18_vicious_hellhound.request() )
         {
-          if ( p -> pets.t18_vicious_hellhound[i] -> is_sleeping() )
-          {
-            p -> pets.t18_vicious_hellhound[i] -> summon( vicious_hellhound_duration );
-            p -> procs.t18_vicious_hellhound -> occur();
-            break;
-          }
+          demon -> summon( vicious_hellhound_duration );
+          p -> procs.t18_vicious_hellhound -> occur();
         }
       }
       else // 45% chance to spawn illidari
       {
-        for ( size_t i = 0; i < p -> pets.t18_illidari_satyr.size(); i++ )
+        if ( pet_t* demon = p -> pets.t18_illidari_satyr.request() )
         {
-          if ( p -> pets.t18_illidari_satyr[i] -> is_sleeping() )
-          {
-            p -> pets.t18_illidari_satyr[i] -> summon( illidari_satyr_duration );
-            p -> procs.t18_illidari_satyr -> occur();
-            break;
-          }
+          demon -> summon( illidari_satyr_duration );
+          p -> procs.t18_illidari_satyr -> occur();
         }
       }
     }
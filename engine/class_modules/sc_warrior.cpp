@@ -502,6 +502,7 @@ public:
                     weapons_master( ab::data().affected_by( player -> mastery.weapons_master -> effectN( 1 ) ) )
   {
     ab::may_crit = true;
+    ab::dynamic_cooldown_reduction = headlongrush;
   }
 
   virtual ~warrior_action_t() {}
@@ -2159,6 +2160,8 @@ struct mortal_strike_t: public warrior_attack_t
     weapon_multiplier *= 1.0 + p -> sets.set( SET_MELEE, T14, B2 ) -> effectN( 1 ).percent();
     weapon_multiplier *= 1.0 + p -> sets.set( SET_MELEE, T16, B2 ) -> effectN( 1 ).percent();
     base_costs[RESOURCE_RAGE] += p -> sets.set( WARRIOR_ARMS, T17, B4 ) -> effectN( 1 ).resource( RESOURCE_RAGE );
+    // Tier 17 2pc Arms shortens the cooldown while its buff is up
+    dynamic_cooldown_reduction = dynamic_cooldown_reduction || p -> sets.has_set_bonus( WARRIOR_ARMS, T17, B2 );
   }
 
   void execute() override
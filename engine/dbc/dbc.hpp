@@ -10,6 +10,7 @@
 #include "util/generic.hpp"
 #include "sc_timespan.hpp"
 #include <string>
+#include <cstring>
 #include <functional>
 #include <unordered_map>
 #include <iostream>
@@ -68,6 +69,7 @@ const item_data_t* items( bool ptr );
 item_data_t* __items_noptr();
 item_data_t* __items_ptr();
 std::size_t        n_items( bool ptr );
+const char*        item_name( const item_data_t* item );
 std::size_t        n_items_noptr();
 std::size_t        n_items_ptr();
 const item_set_bonus_t* set_bonus( bool ptr );
@@ -1554,4 +1556,50 @@ public:
   }
 };
 
+// Sorted name index. Key is either a const char* pointing to (static) client
+// data, compared exactly, or a std::string for derived keys, such as tokenized
+// names. Entries with equal keys retain the order they were added in, so the
+// first entry of a range is the one a linear scan over the data would find.
+template <typename T, typename Key = const char*>
+class dbc_name_index_t
+{
+public:
+  typedef std::pair<Key, T*> entry_t;
+  typedef typename std::vector<entry_t>::const_iterator citerator;
+
+private:
+  struct key_compare
+  {
+    static int cmp( const char* l, const char* r )
+    { return strcmp( l, r ); }
+    static int cmp( const std::string& l, const std::string& r )
+    { return l.compare( r ); }
+
+    bool operator()( const entry_t& l, const entry_t& r ) const
+    { return cmp( l.first, r.first ) < 0; }
+    bool operator()( const entry_t& l, const Key& r ) const
+    { return cmp( l.first, r ) < 0; }
+    bool operator()( const Key& l, const entry_t& r ) const
+    { return cmp( l, r.first ) < 0; }
+  };
+
+#if SC_USE_PTR == 0
+  std::vector<entry_t> idx[ 1 ];
+#else
+  std::vector<entry_t> idx[ 2 ];
+#endif
+
+public:
+  void add( bool ptr, const Key& key, T* data )
+  { idx[ maybe_ptr( ptr ) ].push_back( entry_t( key, data ) ); }
+
+  // Sort the index, must be called after all entries are added
+  void sort( bool ptr )
+  { std::stable_sort( idx[ maybe_ptr( ptr ) ].begin(), idx[ maybe_ptr( ptr ) ].end(), key_compare() ); }
+
+  // Range of entries matching the given key
+  std::pair<citerator, citerator> find( bool ptr, const Key& key ) const
+  { return std::equal_range( idx[ maybe_ptr( ptr ) ].begin(), idx[ maybe_ptr( ptr ) ].end(), key, key_compare() ); }
+};
+
 #endif // SC_DBC_HPP
@@ -77,6 +77,9 @@ public:
 spelltoken_t tokens;
 
 dbc_index_t<spell_data_t> spell_data_index;
+dbc_name_index_t<spell_data_t> spell_name_index;
+dbc_name_index_t<talent_data_t> talent_name_index;
+dbc_name_index_t<talent_data_t, std::string> talent_token_index;
 dbc_index_t<spelleffect_data_t> spelleffect_data_index;
 dbc_index_t<talent_data_t> talent_data_index;
 
@@ -229,6 +232,26 @@ static void generate_class_flags_index( bool ptr = false )
   }
 }
 
+/* Build name indices for spell and talent lookups by name
+ */
+static void generate_name_index( bool ptr = false )
+{
+  for ( spell_data_t* p = spell_data_t::list( ptr ); p -> name_cstr(); ++p )
+    spell_name_index.add( ptr, p -> name_cstr(), p );
+  spell_name_index.sort( ptr );
+
+  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
+  {
+    talent_name_index.add( ptr, p -> name_cstr(), p );
+
+    std::string tokenized_name = p -> name_cstr();
+    util::tokenize( tokenized_name );
+    talent_token_index.add( ptr, tokenized_name, p );
+  }
+  talent_name_index.sort( ptr );
+  talent_token_index.sort( ptr );
+}
+
 /* Initialize database
  */
 void dbc::init()
@@ -259,6 +282,10 @@ void dbc::init()
   generate_class_flags_index();
   if ( SC_USE_PTR )
     generate_class_flags_index( true );
+
+  generate_name_index();
+  if ( SC_USE_PTR )
+    generate_name_index( true );
 }
 
 /* De-Initialize database
@@ -1701,13 +1728,10 @@ spell_data_t* spell_data_t::find( unsigned spell_id, const char* confirmation, b
 
 spell_data_t* spell_data_t::find( const char* name, bool ptr )
 {
-  for ( spell_data_t* p = spell_data_t::list( ptr ); p -> name_cstr(); ++p )
-  {
-    if ( ! strcmp ( name, p -> name_cstr() ) )
-    {
-      return p;
-    }
-  }
+  auto range = spell_name_index.find( ptr, name );
+  if ( range.first != range.second )
+    return range.first -> second;
+
   return nullptr;
 }
 
@@ -1773,12 +1797,11 @@ talent_data_t* talent_data_t::find( unsigned id, const char* confirmation, bool
 
 talent_data_t* talent_data_t::find( const char* name_cstr, specialization_e spec, bool ptr )
 {
-  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
+  auto range = talent_name_index.find( ptr, name_cstr );
+  for ( auto it = range.first; it != range.second; ++it )
   {
-    if ( ! strcmp( name_cstr, p -> name_cstr() ) && p -> specialization() == spec )
-    {
-      return p;
-    }
+    if ( it -> second -> specialization() == spec )
+      return it -> second;
   }
 
   return nullptr;
@@ -1786,12 +1809,17 @@ talent_data_t* talent_data_t::find( const char* name_cstr, specialization_e spec
 
 talent_data_t* talent_data_t::find_tokenized( const char* name, specialization_e spec, bool ptr )
 {
-  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
+  // Tokenized names are lower case, so a lower cased key gives a case
+  // insensitive match
+  std::string key = name;
+  for ( auto& c : key )
+    c = std::tolower( static_cast<unsigned char>( c ) );
+
+  auto range = talent_token_index.find( ptr, key );
+  for ( auto it = range.first; it != range.second; ++it )
   {
-    std::string tokenized_name = p -> name_cstr();
-    util::tokenize( tokenized_name );
-    if ( util::str_compare_ci( name, tokenized_name ) && p -> specialization() == spec )
-      return p;
+    if ( it -> second -> specialization() == spec )
+      return it -> second;
   }
 
   return nullptr;
@@ -30,6 +30,155 @@ namespace {
   typedef filtered_dbc_index_t<item_data_t, potion_filter_t<item_data_t>, id_member_policy> potion_data_t;
 
   potion_data_t potion_data_index;
+
+  // Binary item data file, mapped into memory at startup. The file is written
+  // by dbc_extract.py (-t item -o binary) and uses the (packed) layout of
+  // item_data_t directly, so the records can be used in-place. The only
+  // pointer member (name) is stored as an offset into the string table, and
+  // resolved on access through dbc::item_name(). The mapping is read-only, so
+  // all processes using the same file share its pages with the page cache.
+  //
+  // Layout:
+  // header | records (n_records + 1 zero terminator) | string table
+  struct item_data_file_header_t
+  {
+    char     magic[ 8 ];      // "SCITEMDB"
+    uint32_t version;         // ITEM_DATA_FILE_VERSION
+    uint32_t build_level;     // Client build the data was extracted from
+    uint32_t ptr;             // Non-zero for PTR data
+    uint32_t record_size;     // sizeof( item_data_t ) of the writer
+    uint32_t name_offset;     // offsetof( item_data_t, name ) of the writer
+    uint32_t n_records;       // Number of records, excluding terminator
+    uint64_t records_offset;  // Offset of first record from start of file
+    uint64_t strings_offset;  // Offset of string table from start of file
+    uint64_t strings_size;    // Size of the string table in bytes
+  };
+
+  const unsigned ITEM_DATA_FILE_VERSION = 1;
+
+  struct item_data_file_t
+  {
+    io::mapped_file_t file;
+    const item_data_t* data;
+    std::size_t n_items;
+    const char* strings;
+
+    item_data_file_t() : data( 0 ), n_items( 0 ), strings( 0 ) { }
+
+    bool contains( const item_data_t* item ) const
+    { return data && item >= data && item <= data + n_items; }
+  };
+
+#if SC_USE_PTR
+  item_data_file_t item_data_file[ 2 ];
+#else
+  item_data_file_t item_data_file[ 1 ];
+#endif
+
+  bool map_item_data( item_data_file_t& f, const std::string& path, bool ptr )
+  {
+    if ( ! f.file.open( path ) )
+      return false;
+
+    const char* base = f.file.data();
+    std::size_t size = f.file.size();
+    item_data_file_header_t header;
+
+    if ( size < sizeof( header ) )
+      return false;
+
+    memcpy( &header, base, sizeof( header ) );
+
+    if ( memcmp( header.magic, "SCITEMDB", sizeof( header.magic ) ) != 0 ||
+         header.version != ITEM_DATA_FILE_VERSION )
+    {
+      std::cerr << "Unsupported item data file '" << path << "', ignoring." << std::endl;
+      return false;
+    }
+
+    // Records are used in-place, so the writer must agree with the layout of
+    // this binary. A 32-bit client cannot use data written for 64-bit, etc.
+    if ( header.record_size != sizeof( item_data_t ) ||
+         header.name_offset != offsetof( item_data_t, name ) )
+    {
+      std::cerr << "Item data file '" << path << "' has incompatible record layout, ignoring." << std::endl;
+      return false;
+    }
+
+    // Item data must match the rest of the (compiled in) client data
+    if ( header.build_level != static_cast<unsigned>( dbc::build_level( ptr ) ) ||
+         ( header.ptr != 0 ) != ptr )
+    {
+      std::cerr << "Item data file '" << path << "' is for build " << header.build_level
+                << ", expected " << dbc::build_level( ptr ) << ", ignoring." << std::endl;
+      return false;
+    }
+
+    uint64_t records_end = header.records_offset + ( static_cast<uint64_t>( header.n_records ) + 1 ) * sizeof( item_data_t );
+    if ( records_end > size || header.strings_offset < records_end ||
+         header.strings_size == 0 || header.strings_offset + header.strings_size > size ||
+         base[ header.strings_offset + header.strings_size - 1 ] != '\0' )
+    {
+      std::cerr << "Item data file '" << path << "' is truncated, ignoring." << std::endl;
+      return false;
+    }
+
+    const item_data_t* records = reinterpret_cast<const item_data_t*>( base + header.records_offset );
+
+    // Names are (pointer sized) string table offsets, with 0 denoting no
+    // name. Only validate them here; the records are never written.
+    for ( std::size_t i = 0; i <= header.n_records; i++ )
+    {
+      uintptr_t offset = reinterpret_cast<uintptr_t>( records[ i ].name );
+      if ( offset >= header.strings_size )
+      {
+        std::cerr << "Item data file '" << path << "' has an invalid name offset, ignoring." << std::endl;
+        return false;
+      }
+    }
+
+    if ( records[ header.n_records ].id != 0 )
+    {
+      std::cerr << "Item data file '" << path << "' is not terminated, ignoring." << std::endl;
+      return false;
+    }
+
+    f.data = records;
+    f.n_items = header.n_records;
+    f.strings = base + header.strings_offset;
+
+    return true;
+  }
+
+#ifndef SC_SHARED_DATA
+  #define SC_SHARED_DATA ".."
+#endif
+
+  // Look for a binary item data file in the usual locations. Returns false if
+  // no (usable) file is found, in which case the compiled in data is used.
+  bool load_item_data( bool ptr )
+  {
+    item_data_file_t& f = item_data_file[ maybe_ptr( ptr ) ];
+    const char* paths[] = { ".", "dbc/generated", "engine/dbc/generated", SC_SHARED_DATA };
+    std::string filename = ptr ? "sc_item_data_ptr.bin" : "sc_item_data.bin";
+
+    for ( const char* path : paths )
+    {
+      if ( *path == '\0' )
+        continue;
+
+      if ( map_item_data( f, std::string( path ) + "/" + filename, ptr ) )
+        return true;
+
+      f.file.close();
+    }
+
+#if defined( SC_EXTERNAL_ITEM_DATA )
+    std::cerr << "Unable to load item data from '" << filename << "', no item data available." << std::endl;
+#endif
+
+    return false;
+  }
 }
 
 const item_name_description_t* dbc::item_name_descriptions( bool ptr )
@@ -379,9 +528,29 @@ const item_data_t* dbc::items( bool ptr )
   if ( ptr )
     p = __items_ptr();
 #endif
+
+  if ( item_data_file[ maybe_ptr( ptr ) ].data )
+    p = item_data_file[ maybe_ptr( ptr ) ].data;
+
   return p;
 }
 
+// Name of an item record. Records mapped from a binary item data file hold a
+// string table offset instead of a pointer, see item_data_file_t.
+const char* dbc::item_name( const item_data_t* item )
+{
+  for ( const item_data_file_t& f : item_data_file )
+  {
+    if ( f.contains( item ) )
+    {
+      uintptr_t offset = reinterpret_cast<uintptr_t>( item -> name );
+      return offset ? f.strings + offset : 0;
+    }
+  }
+
+  return item -> name;
+}
+
 size_t dbc::n_items( bool ptr )
 {
   ( void )ptr;
@@ -392,6 +561,9 @@ size_t dbc::n_items( bool ptr )
     n = n_items_ptr();
 #endif
 
+  if ( item_data_file[ maybe_ptr( ptr ) ].data )
+    n = item_data_file[ maybe_ptr( ptr ) ].n_items;
+
   return n;
 }
 
@@ -468,15 +640,21 @@ const item_armor_type_data_t& dbc_t::item_armor_inv_type( unsigned inv_type ) co
  */
 void dbc::init_item_data()
 {
+  // Prefer a binary item data file, if one is available
+  load_item_data( false );
+#if SC_USE_PTR
+  load_item_data( true );
+#endif
+
   // Create id-indexes
-  item_data_index.init( __items_noptr(), false );
+  item_data_index.init( const_cast<item_data_t*>( items( false ) ), false );
   item_enchantment_data_index.init( __spell_item_ench_data, false );
-  potion_data_index.init( __items_noptr(), false );
+  potion_data_index.init( const_cast<item_data_t*>( items( false ) ), false );
 
 #if SC_USE_PTR
-  item_data_index.init( __items_ptr(), true );
+  item_data_index.init( const_cast<item_data_t*>( items( true ) ), true );
   item_enchantment_data_index.init( __ptr_spell_item_ench_data, true );
-  potion_data_index.init( __items_ptr(), true );
+  potion_data_index.init( const_cast<item_data_t*>( items( true ) ), true );
 #endif
 }
 
@@ -1204,7 +1382,7 @@ bool item_database::load_item_from_data( item_t& item )
   if ( ! data || ! data -> id ) return false;
 
   item.parsed.data = *data;
-  item.name_str = data -> name;
+  item.name_str = dbc::item_name( data );
   item.parsed.data.name = item.name_str.c_str();
 
   util::tokenize( item.name_str );
@@ -1247,7 +1425,7 @@ bool item_database::download_glyph( player_t* player, std::string& glyph_name,
 
   if ( gid <= 0 || ! glyph ) return false;
 
-  glyph_name = glyph -> name;
+  glyph_name = dbc::item_name( glyph );
 
   return true;
 }
@@ -8,7 +8,13 @@
  */
 
 #include "dbc.hpp"
+#if defined( SC_EXTERNAL_ITEM_DATA )
+// Item data is loaded at runtime from sc_item_data.bin, see dbc::init_item_data()
+#define ITEM_SIZE (0)
+static item_data_t __item_data[] = { { 0 } };
+#else
 #include "generated/sc_item_data.inc"
+#endif
 
 item_data_t* dbc::__items_noptr()
 {
@@ -9,7 +9,13 @@
 
 #include "dbc.hpp"
 #if SC_USE_PTR
+#if defined( SC_EXTERNAL_ITEM_DATA )
+// Item data is loaded at runtime from sc_item_data_ptr.bin, see dbc::init_item_data()
+#define PTR_ITEM_SIZE (0)
+static item_data_t __ptr_item_data[] = { { 0 } };
+#else
 #include "generated/sc_item_data_ptr.inc"
+#endif
 
 item_data_t* dbc::__items_ptr()
 {
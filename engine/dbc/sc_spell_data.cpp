@@ -289,14 +289,241 @@ unsigned school_str_to_mask( const std::string& str )
   return mask;
 }
 
+// Spell column index =======================================================
+
+// Queries over the raw spell list ("spell.*") are evaluated on rows of this
+// index instead of on spell id vectors. Rows are the spells in id order, and a
+// selection of rows is a bitmap, so &, | and - are word operations. The class
+// mask, school mask, effect type and attribute flag columns additionally have
+// a bitmap per value, which turns a filter on them into a few bitmap
+// operations instead of a scan over every spell.
+
+typedef std::vector<uint64_t> row_bitmap_t;
+
+void bitmap_and( row_bitmap_t& res, const row_bitmap_t& other )
+{
+  for ( size_t i = 0; i < res.size(); i++ )
+    res[ i ] &= other[ i ];
+}
+
+void bitmap_or( row_bitmap_t& res, const row_bitmap_t& other )
+{
+  for ( size_t i = 0; i < res.size(); i++ )
+    res[ i ] |= other[ i ];
+}
+
+void bitmap_sub( row_bitmap_t& res, const row_bitmap_t& other )
+{
+  for ( size_t i = 0; i < res.size(); i++ )
+    res[ i ] &= ~other[ i ];
+}
+
+struct spell_column_index_t
+{
+  std::vector<const spell_data_t*> rows;
+  // One bitmap per mask bit, empty if no spell has the bit set
+  std::vector<row_bitmap_t>        class_bits, school_bits;
+  std::map<int, row_bitmap_t>      effect_type_rows;
+
+  // Attribute flags are built on first use, most of the 32 * NUM_SPELL_FLAGS
+  // bits are never queried
+  mutable mutex_t                            attribute_mutex;
+  mutable std::map<unsigned, row_bitmap_t>   attribute_rows;
+
+  explicit spell_column_index_t( bool ptr ) :
+    class_bits( 32 ), school_bits( 32 )
+  {
+    for ( const spell_data_t* spell = spell_data_t::list( ptr ); spell -> id(); spell++ )
+      rows.push_back( spell );
+
+    range::sort( rows, []( const spell_data_t* l, const spell_data_t* r ) { return l -> id() < r -> id(); } );
+    rows.erase( std::unique( rows.begin(), rows.end(),
+                             []( const spell_data_t* l, const spell_data_t* r ) { return l -> id() == r -> id(); } ),
+                rows.end() );
+
+    for ( size_t row = 0; row < rows.size(); row++ )
+    {
+      const spell_data_t* spell = rows[ row ];
+
+      for ( unsigned bit = 0; bit < 32; bit++ )
+      {
+        if ( spell -> class_mask() & ( 1U << bit ) )
+          set( class_bits[ bit ], row );
+
+        if ( spell -> school_mask() & ( 1U << bit ) )
+          set( school_bits[ bit ], row );
+      }
+
+      for ( size_t j = 0; j < spell -> effect_count(); j++ )
+      {
+        const spelleffect_data_t& effect = spell -> effectN( j + 1 );
+        if ( effect.id() > 0 )
+          set( effect_type_rows[ effect.type() ], row );
+      }
+    }
+  }
+
+  // Index of the data set (live or ptr), built on first use
+  static const spell_column_index_t& get( bool ptr )
+  {
+    static mutex_t mutex;
+    static std::unique_ptr<spell_column_index_t> index[ 2 ];
+
+    AUTO_LOCK( mutex );
+    std::unique_ptr<spell_column_index_t>& i = index[ ptr ? 1 : 0 ];
+    if ( ! i )
+      i = std::unique_ptr<spell_column_index_t>( new spell_column_index_t( ptr ) );
+
+    return *i;
+  }
+
+  size_t words() const
+  { return ( rows.size() + 63 ) / 64; }
+
+  void set( row_bitmap_t& bitmap, size_t row ) const
+  {
+    if ( bitmap.empty() )
+      bitmap.assign( words(), 0 );
+
+    bitmap[ row / 64 ] |= uint64_t( 1 ) << ( row % 64 );
+  }
+
+  row_bitmap_t none() const
+  { return row_bitmap_t( words(), 0 ); }
+
+  row_bitmap_t all() const
+  {
+    row_bitmap_t res( words(), ~uint64_t( 0 ) );
+    if ( rows.size() % 64 )
+      res.back() = ( uint64_t( 1 ) << ( rows.size() % 64 ) ) - 1;
+    return res;
+  }
+
+  // Rows with any of the mask bits set
+  row_bitmap_t any_of( const std::vector<row_bitmap_t>& bits, unsigned mask ) const
+  {
+    row_bitmap_t res = none();
+    for ( unsigned bit = 0; bit < 32; bit++ )
+    {
+      if ( ( mask & ( 1U << bit ) ) && ! bits[ bit ].empty() )
+        bitmap_or( res, bits[ bit ] );
+    }
+    return res;
+  }
+
+  // Rows with all of the mask bits set
+  row_bitmap_t all_of( const std::vector<row_bitmap_t>& bits, unsigned mask ) const
+  {
+    row_bitmap_t res = all();
+    for ( unsigned bit = 0; bit < 32; bit++ )
+    {
+      if ( ! ( mask & ( 1U << bit ) ) )
+        continue;
+
+      if ( bits[ bit ].empty() )
+        return none();
+
+      bitmap_and( res, bits[ bit ] );
+    }
+    return res;
+  }
+
+  // Rows with an effect of the given type
+  row_bitmap_t effect_type( int type ) const
+  {
+    std::map<int, row_bitmap_t>::const_iterator i = effect_type_rows.find( type );
+    return i != effect_type_rows.end() ? i -> second : none();
+  }
+
+  // Rows with the attribute flag set, flag is attribute index * 32 + bit
+  row_bitmap_t attribute( unsigned flag ) const
+  {
+    AUTO_LOCK( attribute_mutex );
+
+    std::map<unsigned, row_bitmap_t>::iterator i = attribute_rows.find( flag );
+    if ( i != attribute_rows.end() )
+      return i -> second;
+
+    row_bitmap_t& res = attribute_rows[ flag ];
+    res = none();
+    for ( size_t row = 0; row < rows.size(); row++ )
+    {
+      if ( rows[ row ] -> attribute( flag / 32 ) & ( 1U << ( flag % 32 ) ) )
+        set( res, row );
+    }
+    return res;
+  }
+
+  void to_list( const row_bitmap_t& bitmap, std::vector<uint32_t>& res ) const
+  {
+    res.clear();
+    for ( size_t i = 0; i < bitmap.size(); i++ )
+    {
+      uint64_t w = bitmap[ i ];
+      for ( size_t row = i * 64; w; row++, w >>= 1 )
+      {
+        if ( w & 1 )
+          res.push_back( rows[ row ] -> id() );
+      }
+    }
+  }
+};
+
 // Generic spell list based expression, holds intersection, union for list
 // For these expression types, you can only use two spell lists as parameters
 struct spell_list_expr_t : public spell_data_expr_t
 {
+  // Rows of the spell column index selected by this expression. Raw spell
+  // list queries are evaluated on these, and result_spell_list is only filled
+  // in (spell_list()) when an operand or the query result needs the ids.
+  row_bitmap_t result_rows;
+  bool         has_rows;
+  // Set on the root of the query, whose result is read as a spell id list
+  bool         materialize;
+
   spell_list_expr_t( sim_t* sim, const std::string& name, expr_data_e type = DATA_SPELL, bool eq = false ) :
-    spell_data_expr_t( sim, name, type, eq, TOK_SPELL_LIST ) { }
+    spell_data_expr_t( sim, name, type, eq, TOK_SPELL_LIST ), has_rows( false ), materialize( false ) { }
+
+  const spell_column_index_t& index() const
+  { return spell_column_index_t::get( sim -> dbc.ptr ); }
+
+  const std::vector<uint32_t>& spell_list()
+  {
+    if ( has_rows && result_spell_list.empty() )
+      index().to_list( result_rows, result_spell_list );
+
+    return result_spell_list;
+  }
+
+  // The expression as an indexed operand, or nullptr if its result is an id list
+  static spell_list_expr_t* indexed( spell_data_expr_t* e )
+  {
+    spell_list_expr_t* l = dynamic_cast<spell_list_expr_t*>( e );
+    if ( l && l -> result_tok == TOK_SPELL_LIST && l -> has_rows )
+      return l;
+
+    return nullptr;
+  }
+
+  // Filter result_rows with a comparison against other. Returns false if the
+  // comparison has no indexed form, in which case the list operators are used.
+  virtual bool filter_rows( const spell_data_expr_t& /* other */, token_e /* t */, row_bitmap_t& /* res */ )
+  { return false; }
 
   virtual int evaluate() override
+  {
+    has_rows = false;
+    result_spell_list.clear();
+
+    int tok = evaluate_list();
+
+    if ( materialize && tok == TOK_SPELL_LIST )
+      spell_list();
+
+    return tok;
+  }
+
+  virtual int evaluate_list()
   {
     unsigned spell_id;
 
@@ -306,6 +533,14 @@ struct spell_list_expr_t : public spell_data_expr_t
     {
       case DATA_SPELL:
       {
+        // spell_query_index=0 keeps the whole query on the id list operators
+        if ( sim -> spell_query_index )
+        {
+          result_rows = index().all();
+          has_rows = true;
+          return TOK_SPELL_LIST;
+        }
+
         for ( const spell_data_t* spell = spell_data_t::list( sim -> dbc.ptr ); spell -> id(); spell++ )
           result_spell_list.push_back( spell -> id() );
         break;
@@ -533,7 +768,50 @@ struct sd_expr_binary_t : public spell_list_expr_t
   sd_expr_binary_t( sim_t* sim, const std::string& n, int o, spell_data_expr_t* l, spell_data_expr_t* r ) :
     spell_list_expr_t( sim, n ), operation( o ), left( l ), right( r ) { }
 
-  virtual int evaluate() override
+  // Evaluate the operator on row bitmaps, if both the operands and the
+  // operator allow it
+  bool evaluate_rows()
+  {
+    spell_list_expr_t* l = indexed( left );
+    if ( ! l )
+      return false;
+
+    switch ( operation )
+    {
+      case TOK_AND:
+      case TOK_OR:
+      case TOK_SUB:
+      {
+        spell_list_expr_t* r = indexed( right );
+        if ( ! r )
+          return false;
+
+        result_rows = l -> result_rows;
+        if ( operation == TOK_AND )
+          bitmap_and( result_rows, r -> result_rows );
+        else if ( operation == TOK_OR )
+          bitmap_or( result_rows, r -> result_rows );
+        else
+          bitmap_sub( result_rows, r -> result_rows );
+        break;
+      }
+      default:
+        if ( ! l -> filter_rows( *right, static_cast<token_e>( operation ), result_rows ) )
+          return false;
+        break;
+    }
+
+    has_rows = true;
+    return true;
+  }
+
+  static void materialize_operand( spell_data_expr_t* e )
+  {
+    if ( spell_list_expr_t* l = indexed( e ) )
+      l -> spell_list();
+  }
+
+  virtual int evaluate_list() override
   {
     int  left_result =  left -> evaluate();
 
@@ -552,6 +830,12 @@ struct sd_expr_binary_t : public spell_list_expr_t
       // Data type follows from left side operand
       data_type   = left -> data_type;
 
+      if ( evaluate_rows() )
+        return result_tok;
+
+      materialize_operand( left );
+      materialize_operand( right );
+
       switch ( operation )
       {
         case TOK_EQ:    result_spell_list = *left == *right; break;
@@ -714,30 +998,61 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
     return false;
   }
 
+  // Lists smaller than this are not worth splitting to threads
+  static const size_t PARALLEL_SCAN_MIN_SIZE = 8192;
+
   void build_list( std::vector<uint32_t>& res, const spell_data_expr_t& other, token_e t ) const
   {
-    for ( auto i = result_spell_list.begin(); i != result_spell_list.end(); ++i )
+    size_t n_threads = std::min( static_cast<size_t>( sc_thread_t::cpu_thread_count() ),
+                                 result_spell_list.size() / PARALLEL_SCAN_MIN_SIZE );
+
+    if ( n_threads <= 1 )
     {
-      // Don't bother comparing if this spell id is already in the result set.
-      if ( range::find( res, *i ) != res.end() )
-        continue;
+      build_list( res, other, t, 0, result_spell_list.size() );
+      return;
+    }
 
-      if ( effect_query )
-      {
-        const spell_data_t& spell = *sim -> dbc.spell( *i );
+    // The input list is sorted, so concatenating the slice results in order
+    // gives a sorted result list
+    size_t slice = result_spell_list.size() / n_threads + 1;
+    std::vector<std::vector<uint32_t> > slices( ( result_spell_list.size() + slice - 1 ) / slice );
+    std::vector<thread_pool_t::future_t> tasks;
+    for ( size_t i = 0; i < slices.size(); i++ )
+    {
+      size_t begin = i * slice;
+      size_t end = std::min( begin + slice, result_spell_list.size() );
+      std::vector<uint32_t>* slice_res = &slices[ i ];
+      tasks.push_back( thread_pool_t::instance().submit( [ this, slice_res, &other, t, begin, end ]() {
+        build_list( *slice_res, other, t, begin, end );
+      } ) );
+    }
 
-        // Compare against every spell effect
-        for ( size_t j = 0; j < spell.effect_count(); j++ )
-        {
-          const spelleffect_data_t& effect = spell.effectN( j + 1 );
+    // Every task writes into slices, so all of them have to finish before an
+    // error can leave this scope
+    std::exception_ptr error;
+    for ( size_t i = 0; i < tasks.size(); i++ )
+    {
+      std::exception_ptr e = tasks[ i ].join();
+      if ( e && ! error )
+        error = e;
+    }
 
-          if ( effect.id() > 0 && sim -> dbc.effect( effect.id() ) &&
-               compare( reinterpret_cast<const char*>( &effect ), other, t ) )
-          {
-            res.push_back( *i );
-            break;
-          }
-        }
+    if ( error )
+      std::rethrow_exception( error );
+
+    for ( size_t i = 0; i < slices.size(); i++ )
+      res.insert( res.end(), slices[ i ].begin(), slices[ i ].end() );
+  }
+
+  void build_list( std::vector<uint32_t>& res, const spell_data_expr_t& other, token_e t, size_t begin, size_t end ) const
+  {
+    // Spell list is unique, so every id is compared (and added) once
+    for ( auto i = result_spell_list.begin() + begin; i != result_spell_list.begin() + end; ++i )
+    {
+      if ( effect_query )
+      {
+        if ( compare_row( *sim -> dbc.spell( *i ), other, t ) )
+          res.push_back( *i );
       }
       else
       {
@@ -756,6 +1071,112 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
     }
   }
 
+  // Same operand checks as the list operators below, which report the errors
+  bool valid_operands( const spell_data_expr_t& other, token_e t ) const
+  {
+    switch ( t )
+    {
+      case TOK_EQ:
+      case TOK_NOTEQ:
+        return other.result_tok == TOK_NUM || other.result_tok == TOK_STR;
+      case TOK_LT:
+      case TOK_LTEQ:
+      case TOK_GT:
+      case TOK_GTEQ:
+        return other.result_tok == TOK_NUM &&
+               ( field_type == SD_TYPE_INT || field_type == SD_TYPE_UNSIGNED || field_type == SD_TYPE_DOUBLE );
+      case TOK_IN:
+      case TOK_NOTIN:
+        return other.result_tok == TOK_STR && field_type == SD_TYPE_STR;
+      default:
+        return false;
+    }
+  }
+
+  bool compare_row( const spell_data_t& spell, const spell_data_expr_t& other, token_e t ) const
+  {
+    if ( ! effect_query )
+      return compare( reinterpret_cast<const char*>( &spell ), other, t );
+
+    // Compare against every spell effect
+    for ( size_t j = 0; j < spell.effect_count(); j++ )
+    {
+      const spelleffect_data_t& effect = spell.effectN( j + 1 );
+
+      if ( effect.id() > 0 && compare( reinterpret_cast<const char*>( &effect ), other, t ) )
+        return true;
+    }
+
+    return false;
+  }
+
+  void build_rows( row_bitmap_t& res, const spell_data_expr_t& other, token_e t, size_t begin, size_t end ) const
+  {
+    const spell_column_index_t& idx = index();
+
+    for ( size_t i = begin; i < end; i++ )
+    {
+      uint64_t w = result_rows[ i ];
+      for ( size_t row = i * 64; w; row++, w >>= 1 )
+      {
+        if ( ( w & 1 ) && compare_row( *idx.rows[ row ], other, t ) )
+          res[ i ] |= uint64_t( 1 ) << ( row % 64 );
+      }
+    }
+  }
+
+  virtual bool filter_rows( const spell_data_expr_t& other, token_e t, row_bitmap_t& res ) override
+  {
+    if ( ! valid_operands( other, t ) )
+      return false;
+
+    const spell_column_index_t& idx = index();
+
+    if ( effect_query && t == TOK_EQ && field_type == SD_TYPE_INT && util::str_compare_ci( name_str, "type" ) )
+    {
+      res = idx.effect_type( static_cast<int>( other.result_num ) );
+      bitmap_and( res, result_rows );
+      return true;
+    }
+
+    res = idx.none();
+
+    // Slices are whole bitmap words, so every task writes its own part of res
+    size_t n_words = result_rows.size();
+    size_t n_threads = std::min( static_cast<size_t>( sc_thread_t::cpu_thread_count() ),
+                                 n_words * 64 / PARALLEL_SCAN_MIN_SIZE );
+
+    if ( n_threads <= 1 )
+    {
+      build_rows( res, other, t, 0, n_words );
+      return true;
+    }
+
+    size_t slice = n_words / n_threads + 1;
+    std::vector<thread_pool_t::future_t> tasks;
+    for ( size_t begin = 0; begin < n_words; begin += slice )
+    {
+      size_t end = std::min( begin + slice, n_words );
+      row_bitmap_t* r = &res;
+      tasks.push_back( thread_pool_t::instance().submit( [ this, r, &other, t, begin, end ]() {
+        build_rows( *r, other, t, begin, end );
+      } ) );
+    }
+
+    std::exception_ptr error;
+    for ( size_t i = 0; i < tasks.size(); i++ )
+    {
+      std::exception_ptr e = tasks[ i ].join();
+      if ( e && ! error )
+        error = e;
+    }
+
+    if ( error )
+      std::rethrow_exception( error );
+
+    return true;
+  }
+
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
   {
     std::vector<uint32_t> res;
@@ -980,6 +1401,22 @@ struct spell_class_expr_t : public spell_list_expr_t
 {
   spell_class_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "class", type ) { }
 
+  virtual bool filter_rows( const spell_data_expr_t& other, token_e t, row_bitmap_t& res ) override
+  {
+    if ( other.result_tok != TOK_STR || ( t != TOK_EQ && t != TOK_NOTEQ ) )
+      return false;
+
+    row_bitmap_t matches = index().any_of( index().class_bits, class_str_to_mask( other.result_str ) );
+
+    res = result_rows;
+    if ( t == TOK_EQ )
+      bitmap_and( res, matches );
+    else
+      bitmap_sub( res, matches );
+
+    return true;
+  }
+
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
   {
     std::vector<uint32_t> res;
@@ -1128,6 +1565,20 @@ struct spell_attribute_expr_t : public spell_list_expr_t
 {
   spell_attribute_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "attribute", type ) { }
 
+  virtual bool filter_rows( const spell_data_expr_t& other, token_e t, row_bitmap_t& res ) override
+  {
+    if ( other.result_tok != TOK_NUM || t != TOK_EQ )
+      return false;
+
+    unsigned flag = static_cast<unsigned>( other.result_num );
+    assert( flag < NUM_SPELL_FLAGS * 32 );
+
+    res = index().attribute( flag );
+    bitmap_and( res, result_rows );
+
+    return true;
+  }
+
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
   {
     std::vector<uint32_t> res;
@@ -1164,6 +1615,23 @@ struct spell_school_expr_t : public spell_list_expr_t
 {
   spell_school_expr_t( sim_t* sim, expr_data_e type ) : spell_list_expr_t( sim, "school", type ) { }
 
+  virtual bool filter_rows( const spell_data_expr_t& other, token_e t, row_bitmap_t& res ) override
+  {
+    if ( other.result_tok != TOK_STR || ( t != TOK_EQ && t != TOK_NOTEQ ) )
+      return false;
+
+    unsigned school_mask = school_str_to_mask( other.result_str );
+
+    res = result_rows;
+    // == matches spells with every school of the mask, != spells with none of them
+    if ( t == TOK_EQ )
+      bitmap_and( res, index().all_of( index().school_bits, school_mask ) );
+    else
+      bitmap_sub( res, index().any_of( index().school_bits, school_mask ) );
+
+    return true;
+  }
+
   virtual std::vector<uint32_t> operator==( const spell_data_expr_t& other ) override
   {
     std::vector<uint32_t> res;
@@ -1368,5 +1836,8 @@ spell_data_expr_t* spell_data_expr_t::parse( sim_t* sim, const std::string& expr
     return nullptr;
   }
 
+  if ( spell_list_expr_t* l = dynamic_cast<spell_list_expr_t*>( e ) )
+    l -> materialize = true;
+
   return e;
 }
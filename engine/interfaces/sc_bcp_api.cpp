@@ -8,6 +8,7 @@
 #include "util/rapidjson/document.h"
 #include "util/rapidjson/stringbuffer.h"
 #include "util/rapidjson/prettywriter.h"
+#include <unordered_set>
 
 // ==========================================================================
 // Blizzard Community Platform API
@@ -50,6 +51,54 @@ struct player_spec_t
   std::string region, server, name, url, cleanurl, local_json, origin, talent_spec;
 };
 
+// item_urls ================================================================
+
+void item_urls( std::string& url,
+                std::string& cleanurl,
+                const std::string& region,
+                unsigned item_id,
+                const std::string& apikey )
+{
+  if ( apikey.size() == 32 && region != "cn" ) //China does not have new api endpoints yet.
+  {
+    cleanurl = "https://" + region + ".api.battle.net/wow/item/" + util::to_string( item_id ) + "?locale=en_us&apikey=";
+    url = cleanurl + apikey;
+  }
+  else
+  {
+    url = "http://" + region + ".battle.net/api/wow/item/" + util::to_string( item_id ) + "?locale=en_US";
+    cleanurl = url;
+  }
+}
+
+// character_urls ===========================================================
+
+void character_urls( player_spec_t& player,
+                     const std::string& region,
+                     const std::string& server,
+                     const std::string& name,
+                     const std::string& apikey )
+{
+  if ( apikey.size() == 32 && region != "cn" ) // China does not have new api endpoints yet.
+  {
+    std::string battlenet = "https://" + region + ".api.battle.net/";
+
+    player.cleanurl = battlenet + "wow/character/" +
+      server + '/' + name + "?fields=talents,items,professions&locale=en_US&apikey=";
+    player.url = player.cleanurl + apikey;
+    player.origin = battlenet + "wow/character/" + server + '/' + name + "/advanced";
+  }
+  else
+  {
+    std::string battlenet = "http://" + region + ".battle.net/";
+
+    player.url = battlenet + "api/wow/character/" +
+      server + '/' + name + "?fields=talents,items,professions&locale=en_US";
+    player.cleanurl = player.url;
+    player.origin = battlenet + "wow/en/character/" + server + '/' + name + "/advanced";
+  }
+}
+
 // download_id ==============================================================
 
 bool download_id( rapidjson::Document& d, 
@@ -63,17 +112,7 @@ bool download_id( rapidjson::Document& d,
 
   std::string url;
   std::string cleanurl;
-
-  if ( apikey.size() == 32 && region != "cn" ) //China does not have new api endpoints yet.
-  {
-    cleanurl = "https://" + region + ".api.battle.net/wow/item/" + util::to_string( item_id ) + "?locale=en_us&apikey=";
-    url = cleanurl + apikey;
-  }
-  else
-  {
-    url = "http://" + region + ".battle.net/api/wow/item/" + util::to_string( item_id ) + "?locale=en_US";
-    cleanurl = url;
-  }
+  item_urls( url, cleanurl, region, item_id, apikey );
 
   std::string result;
   if ( ! http::get( result, url, cleanurl, caching ) )
@@ -1122,6 +1161,184 @@ bool download_roster( rapidjson::Document& d,
   return true;
 }
 
+// guild_prefetch_t =========================================================
+
+// Warms the http cache for a guild import. A bounded set of threads fetch the
+// member character documents; each character's equipped item ids are queued
+// once across the whole roster, so items shared between members are only
+// requested a single time. Only items that item_t::download_item would fetch
+// from the bcpapi source are queued. Player creation afterwards runs
+// sequentially against the warm cache, as it mutates the sim.
+
+struct guild_prefetch_t
+{
+  struct request_t
+  {
+    std::string url, cleanurl;
+    bool character;
+  };
+
+  sim_t* sim;
+  std::string region;
+  cache::behavior_e caching;
+  bool throttle;
+  // Items are fetched from the api only when no source before bcpapi in
+  // item_db_sources can provide them
+  bool fetch_items, local_items;
+
+  mutex_t mutex;
+  // Signaled when requests are queued or the last request in flight ends
+  condition_variable_t work_cv;
+  std::vector<request_t> queue;
+  std::unordered_set<unsigned> item_ids;
+  unsigned active;
+  // Wall time at which the next throttled request may start
+  double next_request;
+
+  guild_prefetch_t( sim_t* s, const std::string& r, cache::behavior_e c ) :
+    sim( s ), region( r ), caching( c ), throttle( false ),
+    fetch_items( false ), local_items( false ), active( 0 ), next_request( 0 )
+  {
+#ifdef SC_DEFAULT_APIKEY
+    // Keep the default key under the per second api call limit, see
+    // bcp_api::download_player.
+    throttle = sim -> apikey == std::string( SC_DEFAULT_APIKEY ) && region != "cn";
+#endif
+
+    if ( cache::items() != cache::ONLY )
+    {
+      for ( size_t i = 0; i < sim -> item_db_sources.size(); ++i )
+      {
+        const std::string& source = sim -> item_db_sources[ i ];
+        if ( source == "bcpapi" )
+        {
+          fetch_items = true;
+          break;
+        }
+        else if ( source == "local" )
+          local_items = true;
+        else // A web source is tried first
+          break;
+      }
+    }
+  }
+
+  void add_character( const std::string& server, const std::string& name )
+  {
+    player_spec_t player;
+    character_urls( player, region, server, name, sim -> apikey );
+
+    request_t r;
+    r.url = player.url;
+    r.cleanurl = player.cleanurl;
+    r.character = true;
+    queue.push_back( r );
+  }
+
+  // Queue the equipped items of a fetched character document
+  void add_items( const std::string& result )
+  {
+    if ( ! fetch_items )
+      return;
+
+    rapidjson::Document profile;
+    profile.Parse< 0 >( result.c_str() );
+    if ( profile.HasParseError() || ! profile.IsObject() || ! profile.HasMember( "items" ) )
+      return;
+
+    const rapidjson::Value& items = profile[ "items" ];
+    if ( ! items.IsObject() )
+      return;
+
+    AUTO_LOCK( mutex );
+    for ( rapidjson::Value::ConstMemberIterator i = items.MemberBegin(); i != items.MemberEnd(); ++i )
+    {
+      if ( ! i -> value.IsObject() || ! i -> value.HasMember( "id" ) || ! i -> value[ "id" ].IsUint() )
+        continue;
+
+      unsigned item_id = i -> value[ "id" ].GetUint();
+      if ( item_id == 0 || ! item_ids.insert( item_id ).second )
+        continue;
+
+      if ( local_items )
+      {
+        const item_data_t* data = sim -> dbc.item( item_id );
+        if ( data && data -> id )
+          continue;
+      }
+
+      request_t r;
+      item_urls( r.url, r.cleanurl, region, item_id, sim -> apikey );
+      r.character = false;
+      queue.push_back( r );
+    }
+    work_cv.broadcast();
+  }
+
+  // Reserve the next slot under the shared api call limit
+  void wait_for_throttle()
+  {
+    double delay;
+    {
+      AUTO_LOCK( mutex );
+      double now = util::wall_time();
+      next_request = std::max( next_request, now );
+      delay = next_request - now;
+      next_request += 0.25;
+    }
+
+    if ( delay > 0 )
+      sc_thread_t::sleep_seconds( delay );
+  }
+
+  void work()
+  {
+    while ( true )
+    {
+      request_t r;
+      {
+        AUTO_LOCK( mutex );
+        // Character fetches still in flight may queue more items
+        while ( queue.empty() && active > 0 )
+          work_cv.wait( mutex );
+
+        if ( queue.empty() )
+          return;
+
+        r = queue.back();
+        queue.pop_back();
+        ++active;
+      }
+
+      if ( throttle )
+        wait_for_throttle();
+
+      std::string result;
+      bool ok = http::get( result, r.url, r.cleanurl, r.character ? caching : cache::items() );
+      if ( ok && r.character )
+        add_items( result );
+
+      AUTO_LOCK( mutex );
+      if ( --active == 0 )
+        work_cv.broadcast();
+    }
+  }
+
+  void run( unsigned n_threads )
+  {
+    // Pop characters in roster order
+    std::reverse( queue.begin(), queue.end() );
+
+    std::vector<thread_pool_t::future_t> workers;
+    thread_pool_t::instance().reserve( n_threads );
+    for ( unsigned i = 0; i < n_threads; ++i )
+      workers.push_back( thread_pool_t::instance().submit( [ this ]() { work(); } ) );
+
+    for ( auto& w : workers )
+      w.wait();
+  }
+};
+
 } // close anonymous namespace ==============================================
 
 // bcp_api::download_player_html =============================================
@@ -1165,16 +1382,10 @@ player_t* bcp_api::download_player( sim_t*             sim,
 
   player_spec_t player;
 
-  if ( sim -> apikey.size() == 32 && region != "cn" ) // China does not have new api endpoints yet.
-  {
-    std::string battlenet = "https://" + region + ".api.battle.net/";
+  character_urls( player, region, server, name, sim -> apikey );
 
-    player.cleanurl = battlenet + "wow/character/" +
-      server + '/' + name + "?fields=talents,items,professions&locale=en_US&apikey=";
-    player.url = player.cleanurl + sim -> apikey;
-    player.origin = battlenet + "wow/character/" + server + '/' + name + "/advanced";
 #ifdef SC_DEFAULT_APIKEY
-  if ( sim -> apikey == std::string( SC_DEFAULT_APIKEY ) )
+  if ( sim -> apikey == std::string( SC_DEFAULT_APIKEY ) && region != "cn" )
   //This is needed to prevent hitting the 'per second' api call limit.
   // If the character is cached, it still counts as a api use, even though we don't download anything.
   // With cached characters, it's common for 30-40 calls to be made per second when downloading a guild.
@@ -1185,16 +1396,6 @@ player_t* bcp_api::download_player( sim_t*             sim,
     usleep( 250000 );
 #endif
 #endif
-  }
-  else
-  {
-    std::string battlenet = "http://" + region + ".battle.net/";
-
-    player.url = battlenet + "api/wow/character/" +
-      server + '/' + name + "?fields=talents,items,professions&locale=en_US";
-    player.cleanurl = player.url;
-    player.origin = battlenet + "wow/en/character/" + server + '/' + name + "/advanced";
-  }
 
   player.region = region;
   player.server = server;
@@ -1300,6 +1501,17 @@ bool bcp_api::download_guild( sim_t* sim,
 
   range::sort( names );
 
+  if ( sim -> import_threads > 1 && caching != cache::ONLY )
+  {
+    unsigned n_threads = static_cast<unsigned>( std::min( static_cast<size_t>( sim -> import_threads ), names.size() ) );
+
+    guild_prefetch_t prefetch( sim, region, caching );
+    for ( auto& cname : names )
+      prefetch.add_character( server, cname );
+
+    prefetch.run( n_threads );
+  }
+
   for (auto & cname : names)
   {
     
@@ -4,6 +4,7 @@
 // ==========================================================================
 
 #include "simulationcraft.hpp"
+#include <unordered_set>
 
 // Cross-Platform Support for HTTP-Download =================================
 
@@ -21,10 +22,11 @@ namespace { // UNNAMED NAMESPACE ==========================================
 
 const bool HTTP_CACHE_DEBUG = false;
 
-mutex_t cache_mutex;
-
 const unsigned int NETBUFSIZE = 1 << 15;
 
+// Serializes one-time initialization of the platform network libraries
+mutex_t network_init_mutex;
+
 struct url_cache_entry_t
 {
   // Not necessarily UTF-8; may contain zero bytes. Should really be vector<uint8_t>.
@@ -32,21 +34,86 @@ struct url_cache_entry_t
   std::string last_modified_header;
   cache::era_t modified, validated;
 
+  // Body stored in the cache file. Entries loaded from the file leave result
+  // empty until the body is first asked for.
+  uint64_t file_offset;
+  uint32_t file_size;
+  bool stored; // body is in the cache file at file_offset
+  bool dirty;  // result is newer than the body in the cache file
+
   url_cache_entry_t() :
-    modified( cache::INVALID_ERA ), validated( cache::INVALID_ERA )
+    modified( cache::INVALID_ERA ), validated( cache::INVALID_ERA ),
+    file_offset( 0 ), file_size( 0 ), stored( false ), dirty( false )
   {}
 };
 
 typedef std::unordered_map<std::string, url_cache_entry_t> url_db_t;
-url_db_t url_db;
+
+// The url cache is split into shards by url hash, each behind its own mutex,
+// so concurrent imports only contend when they hit the same shard. Downloads
+// happen outside the lock; a url being downloaded is marked pending in its
+// shard so other threads asking for it wait for that result instead of
+// fetching it a second time.
+
+struct url_cache_shard_t
+{
+  mutex_t mutex;
+  url_db_t db;
+  std::unordered_set<std::string> pending;
+  // Signaled whenever a pending download of the shard finishes
+  condition_variable_t download_done;
+};
+
+const unsigned URL_CACHE_SHARDS = 16;
+url_cache_shard_t url_cache[ URL_CACHE_SHARDS ];
+
+url_cache_shard_t& cache_shard( const std::string& url )
+{ return url_cache[ std::hash<std::string>()( url ) % URL_CACHE_SHARDS ]; }
+
+// Locks every shard, for operations on the whole cache
+struct all_shards_lock_t
+{
+  all_shards_lock_t()
+  { for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i ) url_cache[ i ].mutex.lock(); }
+  ~all_shards_lock_t()
+  { for ( unsigned i = URL_CACHE_SHARDS; i > 0; --i ) url_cache[ i - 1 ].mutex.unlock(); }
+};
+
+// The cache file currently backing stored entries. Only replaced while all
+// shards are locked, so a reader holding its shard lock can copy bodies out
+// of the mapping safely.
+io::mapped_file_t cache_file;
+
+// replace_file =============================================================
+
+bool replace_file( const std::string& from, const std::string& to )
+{
+#if defined( SC_WINDOWS )
+  return MoveFileExW( io::widen( from ).c_str(), io::widen( to ).c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+  return std::rename( from.c_str(), to.c_str() ) == 0;
+#endif
+}
+
+// load_body ================================================================
+
+// Requires the entry's shard lock to be held.
+void load_body( url_cache_entry_t& entry )
+{
+  if ( entry.stored && ! entry.dirty && entry.result.empty() && entry.file_size > 0 )
+    entry.result.assign( cache_file.data() + entry.file_offset, entry.file_size );
+}
 
 // cache_clear ==============================================================
 
 void cache_clear()
 {
-  // writer lock
-  auto_lock_t lock( cache_mutex );
-  url_db.clear();
+  for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
+  {
+    // writer lock
+    auto_lock_t lock( url_cache[ i ].mutex );
+    url_cache[ i ].db.clear();
+  }
 }
 
 const char* const cookies =
@@ -88,7 +155,7 @@ bool download( url_cache_entry_t&,
 bool download( url_cache_entry_t& entry,
                       const std::string& url )
 {
-  // Requires cache_mutex to be held.
+  // Called without any cache lock held; entry is a private copy.
 
   class InetWrapper : private noncopyable
   {
@@ -101,12 +168,15 @@ bool download( url_cache_entry_t& entry,
   };
 
   static HINTERNET hINet;
-  if ( !hINet )
   {
-    // hINet = InternetOpen( L"simulationcraft", INTERNET_OPEN_TYPE_PROXY, "proxy-server", NULL, 0 );
-    hINet = InternetOpenW( L"simulationcraft", INTERNET_OPEN_TYPE_PRECONFIG, NULL, NULL, 0 );
-    if ( ! hINet )
-      return false;
+    auto_lock_t init_lock( network_init_mutex );
+    if ( !hINet )
+    {
+      // hINet = InternetOpen( L"simulationcraft", INTERNET_OPEN_TYPE_PROXY, "proxy-server", NULL, 0 );
+      hINet = InternetOpenW( L"simulationcraft", INTERNET_OPEN_TYPE_PRECONFIG, NULL, NULL, 0 );
+      if ( ! hINet )
+        return false;
+    }
   }
 
   std::wstring headers = io::widen( cookies );
@@ -210,6 +280,10 @@ struct SocketWrapper
   { ::close( fd ); fd = -1; }
 };
 
+// gethostbyname returns static storage, so lookups from concurrent
+// downloads have to be serialized.
+mutex_t resolve_mutex;
+
 int SocketWrapper::connect( const std::string& host, unsigned short port )
 {
   struct hostent* h;
@@ -217,23 +291,27 @@ int SocketWrapper::connect( const std::string& host, unsigned short port )
 
   a.sin_family = AF_INET;
 
-  if ( proxy.type == "http" || proxy.type == "https" )
   {
-    h = gethostbyname( proxy.host.c_str() );
-    a.sin_port = htons( proxy.port );
-  }
-  else
-  {
-    h = gethostbyname( host.c_str() );
-    a.sin_port = htons( port );
+    auto_lock_t lock( resolve_mutex );
+
+    if ( proxy.type == "http" || proxy.type == "https" )
+    {
+      h = gethostbyname( proxy.host.c_str() );
+      a.sin_port = htons( proxy.port );
+    }
+    else
+    {
+      h = gethostbyname( host.c_str() );
+      a.sin_port = htons( port );
+    }
+    if ( ! h ) return -1;
+
+    std::memcpy( &a.sin_addr, h -> h_addr_list[ 0 ], sizeof( a.sin_addr ) );
   }
-  if ( ! h ) return -1;
 
   if ( ( fd = ::socket( PF_INET, SOCK_STREAM, IPPROTO_TCP ) ) < 0 )
     return -1;
 
-  std::memcpy( &a.sin_addr, h -> h_addr_list[ 0 ], sizeof( a.sin_addr ) );
-
   return ::connect( fd, reinterpret_cast<const sockaddr*>( &a ), sizeof( a ) );
 }
 
@@ -602,21 +680,25 @@ std::string build_request( const url_t&       url,
 bool download( url_cache_entry_t& entry,
                       const std::string& url )
 {
+  {
+    auto_lock_t init_lock( network_init_mutex );
+
 #if defined( SC_MINGW )
 
-  static bool initialized = false;
-  if ( ! initialized )
-  {
-    WSADATA wsa_data;
-    WSAStartup( MAKEWORD( 2, 2 ), &wsa_data );
-    initialized = true;
-  }
+    static bool initialized = false;
+    if ( ! initialized )
+    {
+      WSADATA wsa_data;
+      WSAStartup( MAKEWORD( 2, 2 ), &wsa_data );
+      initialized = true;
+    }
 
 #endif
 
 #if defined( SC_USE_OPENSSL )
-  SSLWrapper::init();
+    SSLWrapper::init();
 #endif
+  }
 
   std::string current_url = url;
   unsigned int redirect = 0;
@@ -774,98 +856,387 @@ bool http::clear_cache( sim_t* sim,
 
 // http::cache_load =========================================================
 
+// The cache is kept in two files. The data file is an append-only log of
+// records ( url, last modified header, body ); a url appearing more than once
+// is superseded by its latest record. The index file ( data file + ".idx" )
+// lists the url, header and body location of the latest record for each url,
+// and how much of the data file it covers. Loading reads only the index and
+// any records appended after it was written, then maps the data file so that
+// bodies are read on first use. Saving appends new and changed bodies, and
+// rewrites the whole data file only once most of it is superseded records.
+
 namespace cache {
-std::string get( std::istream& is )
+
+const char DATA_MAGIC[ 8 ]  = { 'S', 'C', 'H', 'T', 'T', 'P', 'D', '1' };
+const char INDEX_MAGIC[ 8 ] = { 'S', 'C', 'H', 'T', 'T', 'P', 'I', '1' };
+
+// Data files smaller than this are never compacted
+const uint64_t COMPACT_MIN_SIZE = 1 << 20;
+
+struct file_header_t
 {
-  std::string result;
-  while ( is )
+  char magic[ 8 ];
+  char version[ 24 ];   // SC_VERSION, zero padded
+  uint64_t generation;  // Changes whenever the data file is rewritten
+};
+
+struct index_header_t
+{
+  char magic[ 8 ];
+  uint64_t generation;  // Generation of the data file indexed
+  uint64_t data_size;   // Length of the data file covered by the index
+  uint64_t n_entries;
+};
+
+struct record_header_t
+{
+  uint32_t url_size;
+  uint32_t last_modified_size;
+  uint32_t body_size;
+};
+
+// Generation of the currently mapped data file
+uint64_t generation = 0;
+
+void init_header( file_header_t& h, uint64_t g )
+{
+  std::memset( &h, 0, sizeof( h ) );
+  std::memcpy( h.magic, DATA_MAGIC, sizeof( h.magic ) );
+  std::strncpy( h.version, SC_VERSION, sizeof( h.version ) - 1 );
+  h.generation = g;
+}
+
+bool valid_header( const char* data, std::size_t size )
+{
+  if ( size < sizeof( file_header_t ) )
+    return false;
+
+  file_header_t expected;
+  init_header( expected, 0 );
+  return std::memcmp( data, expected.magic, sizeof( expected.magic ) ) == 0 &&
+         std::memcmp( data + sizeof( expected.magic ), expected.version, sizeof( expected.version ) ) == 0;
+}
+
+std::string index_name( const std::string& file_name )
+{ return file_name + ".idx"; }
+
+// Requires all shards to be locked.
+void add_entry( const std::string& url, const std::string& last_modified,
+                uint64_t offset, uint32_t size )
+{
+  url_cache_entry_t& c = cache_shard( url ).db[ url ];
+  c.result.clear();
+  c.last_modified_header = last_modified;
+  c.modified = c.validated = cache::IN_THE_BEGINNING;
+  c.file_offset = offset;
+  c.file_size = size;
+  c.stored = true;
+  c.dirty = false;
+}
+
+// Reads the index file, returning the length of the data file it covers, or
+// 0 if it is missing or does not belong to the mapped data file.
+uint64_t load_index( const std::string& file_name, uint64_t data_size )
+{
+  io::cfile f( index_name( file_name ), "rb" );
+  if ( ! f )
+    return 0;
+
+  index_header_t h;
+  if ( std::fread( &h, sizeof( h ), 1, f ) != 1 ||
+       std::memcmp( h.magic, INDEX_MAGIC, sizeof( h.magic ) ) != 0 ||
+       h.generation != generation || h.data_size > data_size )
+    return 0;
+
+  std::string url, last_modified;
+  for ( uint64_t i = 0; i < h.n_entries; ++i )
   {
-    unsigned char c = is.get();
-    if ( ! c )
-      break;
-    result += c;
+    record_header_t r;
+    uint64_t offset;
+    if ( std::fread( &r, sizeof( r ), 1, f ) != 1 ||
+         std::fread( &offset, sizeof( offset ), 1, f ) != 1 )
+      return 0;
+
+    url.resize( r.url_size );
+    last_modified.resize( r.last_modified_size );
+    if ( ( r.url_size && std::fread( &url[ 0 ], r.url_size, 1, f ) != 1 ) ||
+         ( r.last_modified_size && std::fread( &last_modified[ 0 ], r.last_modified_size, 1, f ) != 1 ) )
+      return 0;
+
+    if ( offset + r.body_size > h.data_size )
+      return 0;
+
+    add_entry( url, last_modified, offset, r.body_size );
   }
-  return result;
+
+  return h.data_size;
 }
 
-void put( std::ostream& os, const std::string& s )
-{ os.write( s.c_str(), s.size() + 1 ); }
+// Reads the records of the mapped data file from offset on. A truncated
+// record at the end (eg. from an interrupted save) is ignored.
+void scan_records( uint64_t offset )
+{
+  const char* data = cache_file.data();
+  uint64_t size = cache_file.size();
+
+  while ( offset + sizeof( record_header_t ) <= size )
+  {
+    record_header_t r;
+    std::memcpy( &r, data + offset, sizeof( r ) );
+    uint64_t body = offset + sizeof( r ) + r.url_size + r.last_modified_size;
+    if ( body + r.body_size > size )
+      break;
+
+    std::string url( data + offset + sizeof( r ), r.url_size );
+    std::string last_modified( data + offset + sizeof( r ) + r.url_size, r.last_modified_size );
+    add_entry( url, last_modified, body, r.body_size );
 
-void put( std::ostream& os, const char* s )
-{ os.write( s, std::strlen( s ) + 1 ); }
+    offset = body + r.body_size;
+  }
 }
 
-void http::cache_load( const std::string& file_name )
+// Writes a record for the entry, returning false on error. On success the
+// entry refers to the record's body.
+bool write_record( FILE* f, uint64_t& offset, const std::string& url, url_cache_entry_t& entry )
 {
-  auto_lock_t lock( cache_mutex );
+  const std::string& body = entry.result;
+
+  record_header_t r;
+  r.url_size = as<uint32_t>( url.size() );
+  r.last_modified_size = as<uint32_t>( entry.last_modified_header.size() );
+  r.body_size = as<uint32_t>( body.size() );
+
+  if ( std::fwrite( &r, sizeof( r ), 1, f ) != 1 ||
+       std::fwrite( url.data(), 1, url.size(), f ) != url.size() ||
+       std::fwrite( entry.last_modified_header.data(), 1, entry.last_modified_header.size(), f ) != entry.last_modified_header.size() ||
+       std::fwrite( body.data(), 1, body.size(), f ) != body.size() )
+    return false;
+
+  offset += sizeof( r ) + url.size() + entry.last_modified_header.size();
+  entry.file_offset = offset;
+  entry.file_size = r.body_size;
+  entry.stored = true;
+  entry.dirty = false;
+  offset += body.size();
+  return true;
+}
 
-  try
+bool write_index( const std::string& file_name, uint64_t data_size )
+{
+  std::string tmp_name = index_name( file_name ) + ".tmp";
   {
-    io::ifstream file;
-    file.open( file_name, std::ios::binary );
-    if ( !file ) return;
-    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
-    file.unsetf( std::ios::skipws );
+    io::cfile f( tmp_name, "wb" );
+    if ( ! f )
+      return false;
 
-    if ( cache::get( file ) != SC_VERSION )
+    index_header_t h;
+    std::memcpy( h.magic, INDEX_MAGIC, sizeof( h.magic ) );
+    h.generation = generation;
+    h.data_size = data_size;
+    h.n_entries = 0;
+    if ( std::fwrite( &h, sizeof( h ), 1, f ) != 1 )
+      return false;
+
+    for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
     {
-      // invalid version, GTFO
-      return;
+      for ( url_db_t::const_iterator p = url_cache[ i ].db.begin(), e = url_cache[ i ].db.end(); p != e; ++p )
+      {
+        const url_cache_entry_t& c = p -> second;
+        if ( ! c.stored || c.dirty )
+          continue;
+
+        record_header_t r;
+        r.url_size = as<uint32_t>( p -> first.size() );
+        r.last_modified_size = as<uint32_t>( c.last_modified_header.size() );
+        r.body_size = c.file_size;
+        if ( std::fwrite( &r, sizeof( r ), 1, f ) != 1 ||
+             std::fwrite( &c.file_offset, sizeof( c.file_offset ), 1, f ) != 1 ||
+             std::fwrite( p -> first.data(), 1, p -> first.size(), f ) != p -> first.size() ||
+             std::fwrite( c.last_modified_header.data(), 1, c.last_modified_header.size(), f ) != c.last_modified_header.size() )
+          return false;
+        ++h.n_entries;
+      }
     }
 
-    std::string content;
-    content.reserve( 16 * 1024 );
+    if ( std::fseek( f, 0, SEEK_SET ) != 0 || std::fwrite( &h, sizeof( h ), 1, f ) != 1 )
+      return false;
+  }
+
+  return replace_file( tmp_name, index_name( file_name ) );
+}
 
-    while ( ! file.eof() )
-    {
-      std::string url = cache::get( file );
-      std::string last_modified = cache::get( file );
+} // namespace cache
 
-      uint32_t size;
-      file.read( reinterpret_cast<char*>( &size ), sizeof( size ) );
-      content.resize( size );
-      file.read( &content[ 0 ], size );
+void http::cache_load( const std::string& file_name )
+{
+  all_shards_lock_t lock;
 
-      url_cache_entry_t& c = url_db[ url ];
-      c.result = content;
-      c.last_modified_header = last_modified;
-      c.modified = c.validated = cache::IN_THE_BEGINNING;
+  // Entries backed by a previously loaded file are reloaded from this one
+  for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
+  {
+    url_db_t& db = url_cache[ i ].db;
+    for ( url_db_t::iterator p = db.begin(); p != db.end(); )
+    {
+      if ( p -> second.stored && ! p -> second.dirty && p -> second.result.empty() )
+        p = db.erase( p );
+      else
+        ++p;
     }
   }
-  catch ( ... )
-  {}
+
+  cache_file.close();
+  cache::generation = 0;
+
+  if ( ! cache_file.open( file_name ) )
+    return;
+
+  if ( ! cache::valid_header( cache_file.data(), cache_file.size() ) )
+  {
+    // Different version or format; it is replaced on the next save.
+    cache_file.close();
+    return;
+  }
+
+  cache::file_header_t h;
+  std::memcpy( &h, cache_file.data(), sizeof( h ) );
+  cache::generation = h.generation;
+
+  uint64_t indexed = cache::load_index( file_name, cache_file.size() );
+  cache::scan_records( std::max( indexed, static_cast<uint64_t>( sizeof( h ) ) ) );
 }
 
 // http::cache_save =========================================================
 
-void http::cache_save( const std::string& file_name )
-{
-  auto_lock_t lock( cache_mutex );
+namespace cache {
 
-  try
+// Bodies of stored entries are read back from the mapped file on demand
+void release_bodies()
+{
+  for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
   {
-    io::ofstream file;
-    file.open( file_name, std::ios::binary );
-    if ( ! file ) return;
-    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
+    for ( url_db_t::iterator p = url_cache[ i ].db.begin(), e = url_cache[ i ].db.end(); p != e; ++p )
+    {
+      if ( p -> second.stored && ! p -> second.dirty )
+        std::string().swap( p -> second.result );
+    }
+  }
+}
+
+// Appends new and changed entries to the mapped data file. Fails if the file
+// changed on disk since it was mapped.
+bool append_records( const std::string& file_name )
+{
+  io::cfile f( file_name, "r+b" );
+  if ( ! f || std::fseek( f, 0, SEEK_END ) != 0 )
+    return false;
 
-    cache::put( file, SC_VERSION );
+  uint64_t offset = static_cast<uint64_t>( std::ftell( f ) );
+  if ( offset != cache_file.size() )
+    return false;
 
-    for ( url_db_t::const_iterator p = url_db.begin(), e = url_db.end(); p != e; ++p )
+  for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
+  {
+    for ( url_db_t::iterator p = url_cache[ i ].db.begin(), e = url_cache[ i ].db.end(); p != e; ++p )
     {
-      if ( p -> second.validated == cache::INVALID_ERA )
+      url_cache_entry_t& c = p -> second;
+      if ( c.validated == INVALID_ERA || ( c.stored && ! c.dirty ) )
         continue;
 
-      cache::put( file, p -> first );
-      cache::put( file, p -> second.last_modified_header );
+      if ( ! write_record( f, offset, p -> first, c ) )
+        return false;
+    }
+  }
+
+  f.close();
+  write_index( file_name, offset );
+
+  // Map the grown file, so that the next save can append to it again. The
+  // old mapping stays in place if this fails, and that save compacts.
+  io::mapped_file_t grown;
+  if ( grown.open( file_name ) && grown.size() == offset )
+  {
+    cache_file.swap( grown );
+    release_bodies();
+  }
+
+  return true;
+}
 
-      uint32_t size = as<uint32_t>( p -> second.result.size() );
-      file.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
-      file.write( p -> second.result.data(), size );
+// Rewrites the live entries into a new data file
+void compact( const std::string& file_name )
+{
+  std::string tmp_name = file_name + ".tmp";
+  uint64_t new_generation = static_cast<uint64_t>( std::time( nullptr ) ) << 16 ^ static_cast<uint64_t>( std::clock() );
+  if ( new_generation == 0 || new_generation == generation )
+    ++new_generation;
+
+  uint64_t offset = 0;
+  {
+    io::cfile f( tmp_name, "wb" );
+    if ( ! f )
+      return;
+
+    file_header_t h;
+    init_header( h, new_generation );
+    if ( std::fwrite( &h, sizeof( h ), 1, f ) != 1 )
+      return;
+    offset = sizeof( h );
+
+    for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
+    {
+      for ( url_db_t::iterator p = url_cache[ i ].db.begin(), e = url_cache[ i ].db.end(); p != e; ++p )
+      {
+        url_cache_entry_t& c = p -> second;
+        load_body( c );
+        c.stored = false;
+        if ( c.validated == INVALID_ERA )
+          continue;
+
+        if ( ! write_record( f, offset, p -> first, c ) )
+          return;
+      }
     }
   }
-  catch ( ... )
-  {}
+
+  cache_file.close();
+  if ( ! replace_file( tmp_name, file_name ) )
+    return;
+
+  generation = new_generation;
+  write_index( file_name, offset );
+
+  if ( ! cache_file.open( file_name ) )
+    return;
+
+  release_bodies();
+}
+
+} // namespace cache
+
+void http::cache_save( const std::string& file_name )
+{
+  all_shards_lock_t lock;
+
+  uint64_t live_size = 0;
+  for ( unsigned i = 0; i < URL_CACHE_SHARDS; ++i )
+  {
+    for ( url_db_t::const_iterator p = url_cache[ i ].db.begin(), e = url_cache[ i ].db.end(); p != e; ++p )
+    {
+      const url_cache_entry_t& c = p -> second;
+      if ( c.validated == cache::INVALID_ERA )
+        continue;
+      live_size += sizeof( cache::record_header_t ) + p -> first.size() + c.last_modified_header.size() +
+                   ( c.stored && ! c.dirty ? c.file_size : c.result.size() );
+    }
+  }
+
+  // Append while most of the mapped file is still live, compact otherwise
+  if ( cache_file.is_open() && cache::generation != 0 &&
+       ( cache_file.size() < cache::COMPACT_MIN_SIZE || cache_file.size() <= 2 * live_size ) &&
+       cache::append_records( file_name ) )
+    return;
+
+  cache::compact( file_name );
 }
 
 // http::get ================================================================
@@ -883,9 +1254,26 @@ bool http::get( std::string&       result,
   util::urlencode( encoded_url );
   util::urlencode( encoded_clean_url );
 
-  auto_lock_t lock( cache_mutex );
+  url_cache_shard_t& shard = cache_shard( encoded_clean_url );
+  url_cache_entry_t entry;
+  bool needs_download;
 
-  url_cache_entry_t& entry = url_db[ encoded_clean_url ];
+  {
+    auto_lock_t lock( shard.mutex );
+
+    // Another thread is downloading this url; wait for its result.
+    while ( shard.pending.find( encoded_clean_url ) != shard.pending.end() )
+      shard.download_done.wait( shard.mutex );
+
+    url_cache_entry_t& cached = shard.db[ encoded_clean_url ];
+    load_body( cached );
+    entry = cached;
+    needs_download = entry.validated < cache::era() &&
+                     ( caching == cache::CURRENT || entry.validated == cache::INVALID_ERA );
+    // Claim the download while still holding the shard lock
+    if ( needs_download && caching != cache::ONLY )
+      shard.pending.insert( encoded_clean_url );
+  }
 
   if ( HTTP_CACHE_DEBUG )
   {
@@ -916,14 +1304,29 @@ bool http::get( std::string&       result,
     }
   }
 
-  if ( entry.validated < cache::era() && ( caching == cache::CURRENT || entry.validated == cache::INVALID_ERA ) )
+  if ( needs_download )
   {
     if ( caching == cache::ONLY )
       return false;
 
     util::printf( "@" ); fflush( stdout );
 
-    if ( ! download( entry, encoded_url ) )
+    bool downloaded = download( entry, encoded_url );
+
+    {
+      auto_lock_t lock( shard.mutex );
+      if ( downloaded )
+      {
+        // A new body has to be written to the cache file on save
+        if ( entry.modified == cache::era() )
+          entry.dirty = true;
+        shard.db[ encoded_clean_url ] = entry;
+      }
+      shard.pending.erase( encoded_clean_url );
+      shard.download_done.broadcast();
+    }
+
+    if ( ! downloaded )
       return false;
 
     if ( HTTP_CACHE_DEBUG && entry.modified < entry.validated )
@@ -961,20 +1364,51 @@ int main( int argc, char* argv[] )
     {
       if ( !strcmp( argv[ i ], "--dump" ) )
       {
-        url_db.clear();
+        cache_clear();
         const char* const url_cache_file = "simc_cache.dat";
         http::cache_load( url_cache_file );
 
-        for ( auto& i : url_db )
+        for ( auto& shard : url_cache )
+        {
+          for ( auto& i : shard.db )
+          {
+            load_body( i.second );
+            std::cout << "URL: \"" << i.first << "\" (" << i.second.last_modified_header << ")\n"
+                      << i.second.result << '\n';
+          }
+        }
+      }
+      else if ( !strcmp( argv[ i ], "--parallel" ) && i + 2 < argc )
+      {
+        // Fetches the same url from several threads at once; against a local
+        // stand-in server this should log a single request.
+        int n = atoi( argv[ ++i ] );
+        std::string url = argv[ ++i ];
+        std::vector<char> ok( std::max( n, 0 ) );
+        std::vector<thread_pool_t::future_t> tasks;
+        thread_pool_t::instance().reserve( ok.size() );
+        for ( size_t t = 0; t < ok.size(); ++t )
+        {
+          char* task_ok = &ok[ t ];
+          tasks.push_back( thread_pool_t::instance().submit( [ task_ok, url ]() {
+            std::string result;
+            *task_ok = http::get( result, url, url, cache::ANY );
+          } ) );
+        }
+
+        int failed = 0;
+        for ( size_t t = 0; t < tasks.size(); ++t )
         {
-          std::cout << "URL: \"" << i.first << "\" (" << i.second.last_modified_header << ")\n"
-                    << i.second.result << '\n';
+          tasks[ t ].wait();
+          if ( ! ok[ t ] )
+            ++failed;
         }
+        std::cout << n << " concurrent gets of \"" << url << "\", " << failed << " failed.\n";
       }
       else
       {
         std::string result;
-        if ( http::get( result, argv[ i ], cache::CURRENT ) )
+        if ( http::get( result, argv[ i ], argv[ i ], cache::CURRENT ) )
           std::cout << result << '\n';
         else
           std::cout << "Unable to download \"" << argv[ i ] << "\".\n";
@@ -985,12 +1419,13 @@ int main( int argc, char* argv[] )
   {
     std::string result;
 
-    if ( http::get( result, "http://us.battle.net/wow/en/character/llane/pagezero/advanced", cache::CURRENT ) )
+    if ( http::get( result, "http://us.battle.net/wow/en/character/llane/pagezero/advanced",
+                    "http://us.battle.net/wow/en/character/llane/pagezero/advanced", cache::CURRENT ) )
       std::cout << result << '\n';
     else
       std::cout << "Unable to download armory data.\n";
 
-    if ( http::get( result, "http://www.wowhead.com/list=1564664", cache::CURRENT ) )
+    if ( http::get( result, "http://www.wowhead.com/list=1564664", "http://www.wowhead.com/list=1564664", cache::CURRENT ) )
       std::cout << result << '\n';
     else
       std::cout << "Unable to download wowhead data.\n";
@@ -270,7 +270,7 @@ struct flask_t : public flask_base_t
       if ( item -> item_subclass != ITEM_SUBCLASS_FLASK )
         continue;
 
-      flask_name = item -> name;
+      flask_name = dbc::item_name( item );
 
       util::tokenize( flask_name );
 
@@ -870,7 +870,7 @@ struct dbc_potion_t : public action_t
 
     if ( ! stat_buff )
     {
-      sim -> errorf( "%s: No buff found in potion '%s'.", player -> name(), item -> name );
+      sim -> errorf( "%s: No buff found in potion '%s'.", player -> name(), dbc::item_name( item ) );
       background = true;
       return;
     }
@@ -888,7 +888,7 @@ struct dbc_potion_t : public action_t
 
     if ( cooldown -> duration == timespan_t::zero() )
     {
-      sim -> errorf( "%s: No cooldown found for potion '%s'.", player -> name(), item -> name );
+      sim -> errorf( "%s: No cooldown found for potion '%s'.", player -> name(), dbc::item_name( item ) );
       background = true;
       return;
     }
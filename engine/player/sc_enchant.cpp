@@ -370,7 +370,7 @@ const item_enchantment_data_t& enchant::find_meta_gem( const dbc_t&       dbc,
     if ( gem -> id != data.id_gem )
       continue;
 
-    std::string tokenized_name = gem -> name;
+    std::string tokenized_name = dbc::item_name( gem );
     util::tokenize( tokenized_name );
     std::string shortname;
     std::string::size_type offset = tokenized_name.find( "_diamond" );
@@ -401,7 +401,7 @@ meta_gem_e enchant::meta_gem_type( const dbc_t&                   dbc,
   if ( ! gem )
     return META_GEM_NONE;
 
-  std::string tokenized_name = gem -> name;
+  std::string tokenized_name = dbc::item_name( gem );
   util::tokenize( tokenized_name );
   std::string shortname;
   std::string::size_type offset = tokenized_name.find( "_diamond" );
@@ -499,7 +499,7 @@ std::string item_t::full_name() const
 
   if ( const item_data_t* item = sim -> dbc.item( parsed.data.id ) )
   {
-    n = item -> name;
+    n = dbc::item_name( item );
   }
   else
   {
@@ -27,6 +27,7 @@ void pet_t::init_pet_t_()
   expiration = nullptr;
   duration = timespan_t::zero();
   affects_wod_legendary_ring = true;
+  pool = nullptr;
 
   owner -> pet_list.push_back( this );
 
@@ -34,7 +35,10 @@ void pet_t::init_pet_t_()
   intellect_per_owner = 0.30;
 
   party = owner -> party;
-  regen_type = owner -> regen_type;
+  // Pets regenerate statically unless their class opts them into dynamic
+  // regen, which requires every buff changing the pet's regen rate (including
+  // owner buffs read in the pet's regen()) to bring resources up to date.
+  regen_type = REGEN_STATIC;
 
   // Inherit owner's dbc state
   dbc.ptr = owner -> dbc.ptr;
@@ -142,11 +146,32 @@ void pet_t::init_target()
 
 void pet_t::reset()
 {
+  if ( pool )
+  {
+    if ( this == pool -> prototype() )
+      pool -> reset();
+    // An instance left asleep for a whole iteration is still in its reset state
+    else if ( ! active_during_iteration )
+      return;
+  }
+
   base_t::reset();
 
   expiration = nullptr;
 }
 
+// pet_t::demise ============================================================
+
+void pet_t::demise()
+{
+  bool awake = ! is_sleeping();
+
+  base_t::demise();
+
+  if ( pool && awake )
+    pool -> release( this );
+}
+
 // pet_t::summon ============================================================
 
 void pet_t::summon( timespan_t summon_duration )
@@ -223,6 +248,16 @@ void pet_t::dismiss( bool expired )
   demise();
 }
 
+// pet_t::get_stats ========================================================
+
+stats_t* pet_t::get_stats( const std::string& n, action_t* a )
+{
+  if ( pool && this != pool -> prototype() && ! sim -> report_pets_separately )
+    return pool -> prototype() -> get_stats( n, a );
+
+  return base_t::get_stats( n, a );
+}
+
 // pet_t::assess_damage =====================================================
 
 void pet_t::assess_damage( school_e       school,
@@ -272,6 +307,7 @@ void pet_t::init_resources( bool force )
   resources.initial[ RESOURCE_HEALTH ] = owner -> resources.max[ RESOURCE_HEALTH ] * owner_coeff.health;
 
   resources.current = resources.max = resources.initial;
+  health_changed();
 }
 
 double pet_t::hit_exp() const
@@ -308,3 +344,31 @@ double pet_t::composite_spell_power( school_e school ) const
     sp += owner -> cache.spell_power( school ) * owner -> composite_spell_power_multiplier() * owner_coeff.sp_from_sp;
   return sp;
 }
+
+// ==========================================================================
+// Pet Pool
+// ==========================================================================
+
+// pet_pool_t::add ==========================================================
+
+void pet_pool_t::add( pet_t* p )
+{
+  assert( ! p -> sim -> initialized && "Pooled pets must be created before sim initialization" );
+
+  p -> pool = this;
+  if ( ! pets.empty() && ! p -> sim -> report_pets_separately )
+    p -> quiet = true;
+
+  // Make sure the first reset is not skipped
+  p -> active_during_iteration = true;
+
+  pets.push_back( p );
+}
+
+// pet_pool_t::reset ========================================================
+
+void pet_pool_t::reset()
+{
+  // Requests pop from the back, hand out the prototype first
+  free_list.assign( pets.rbegin(), pets.rend() );
+}
@@ -509,6 +509,7 @@ player_t::player_t( sim_t*             s,
   quiet( false ),
   report_extension( new player_report_extension_t() ),
   iteration_fight_length( timespan_t::zero() ), arise_time( timespan_t::min() ),
+  next_timeline_sample( timespan_t::max() ),
   iteration_waiting_time( timespan_t::zero() ), iteration_executed_foreground_actions( 0 ),
   rps_gain( 0 ), rps_loss( 0 ),
 
@@ -543,7 +544,7 @@ player_t::player_t( sim_t*             s,
   active_during_iteration( false ),
   _mastery( spelleffect_data_t::nil() ),
   cache( this ),
-  regen_type( REGEN_STATIC ),
+  regen_type( REGEN_DYNAMIC ),
   last_regen( timespan_t::zero() ),
   regen_caches( CACHE_MAX ),
   dynamic_regen_pets( false ),
@@ -607,6 +608,12 @@ player_t::player_t( sim_t*             s,
   range::fill( scaling_lag, 0 );
   range::fill( scaling_lag_error, 0 );
 
+  // Base energy/focus regeneration scales with haste, mana regeneration with
+  // spirit; classes add their own regen-affecting caches on top.
+  regen_caches[ CACHE_HASTE ] = true;
+  regen_caches[ CACHE_ATTACK_HASTE ] = true;
+  regen_caches[ CACHE_SPIRIT ] = true;
+
   if ( ! is_pet() )
   {
     items.resize( SLOT_MAX );
@@ -750,30 +757,6 @@ void player_t::init()
     else
       get_action_priority_list( elem.first ) -> action_list_str = elem.second;
   }
-
-  // If the owner is regenerating using dynamic resource regen, we need to
-  // ensure that pets that regen dynamically also get updated correctly. Thus,
-  // we copy any CACHE_x enum values from pets to the owner. Also, if we have
-  // no dynamically regenerating pets, we do not need to go through extra work
-  // in do_dynamic_regen() to call the pets do_dynamic_regen(), saving some cpu
-  // cycles.
-  if ( regen_type == REGEN_DYNAMIC )
-  {
-    for (auto pet : pet_list)
-    {
-      
-      if ( pet -> regen_type != REGEN_DYNAMIC )
-        continue;
-
-      for ( cache_e c = CACHE_NONE; c < CACHE_MAX; c++ )
-      {
-        if ( pet -> regen_caches[ c ] )
-          regen_caches[ c ] = true;
-      }
-
-      dynamic_regen_pets = true;
-    }
-  }
 }
 
 /* Determine Spec, Talents, Professions, Glyphs
@@ -1289,6 +1272,7 @@ void player_t::init_resources( bool force )
   }
 
   resources.current = resources.max = resources.initial;
+  health_changed();
 
   // Only collect pet resource timelines if they get reported separately
   if ( ! is_pet() || sim -> report_pets_separately )
@@ -1855,6 +1839,19 @@ void player_t::init_absorb_priority()
      declare the order of spec-specific high priority absorbs. */
 }
 
+// player_t::init_absorb_sequence ===========================================
+
+void player_t::init_absorb_sequence()
+{
+  // Resolve instant absorbs once, so incoming damage does not look them up
+  absorb_sequence.clear();
+  for ( size_t i = 0; i < absorb_priority.size(); i++ )
+  {
+    auto it = instant_absorb_list.find( absorb_priority[ i ] );
+    absorb_sequence.push_back( std::make_pair( absorb_priority[ i ], it != instant_absorb_list.end() ? it -> second : nullptr ) );
+  }
+}
+
 // player_t::init_scaling ===================================================
 
 void player_t::init_scaling()
@@ -2188,8 +2185,7 @@ bool player_t::init_actions()
   }
 
   int capacity = std::max( 1200, static_cast<int>( sim -> max_time.total_seconds() / 2.0 ) );
-  collected_data.action_sequence.reserve( capacity );
-  collected_data.action_sequence.clear();
+  collected_data.action_sequence_recording.entries.reserve( capacity );
 
   return true;
 }
@@ -2224,6 +2220,30 @@ bool player_t::init_finished()
 
   std::sort( resource_thresholds.begin(), resource_thresholds.end() );
 
+  // If the owner is regenerating using dynamic resource regen, we need to
+  // ensure that pets that regen dynamically also get updated correctly. Thus,
+  // we copy any CACHE_x enum values from pets to the owner. Also, if we have
+  // no dynamically regenerating pets, we do not need to go through extra work
+  // in do_dynamic_regen() to call the pets do_dynamic_regen(), saving some cpu
+  // cycles. Pets are created after the owner is initialized, so this is done
+  // here.
+  if ( regen_type == REGEN_DYNAMIC )
+  {
+    for ( auto pet : pet_list )
+    {
+      if ( pet -> regen_type != REGEN_DYNAMIC || pet -> primary_resource() == RESOURCE_NONE )
+        continue;
+
+      for ( cache_e c = CACHE_NONE; c < CACHE_MAX; c++ )
+      {
+        if ( pet -> regen_caches[ c ] )
+          regen_caches[ c ] = true;
+      }
+
+      dynamic_regen_pets = true;
+    }
+  }
+
   return ret;
 }
 
@@ -3303,6 +3323,8 @@ double player_t::composite_mastery_value() const
 
 void player_t::invalidate_cache( cache_e c )
 {
+  sample_timelines();
+
   if ( ! cache.active ) return;
 
   if ( sim -> debug ) sim -> out_debug.printf( "%s invalidates %s", name(), util::cache_type_string( c ) );
@@ -3373,53 +3395,112 @@ void player_t::invalidate_cache( cache_e c )
 
 #endif
 
+// player_t::sequence_sample_iteration =====================================
+
+// Iteration whose sequence is reported: #1, or #0 for log/debug/iterations=1 sims
+bool player_t::sequence_sample_iteration() const
+{
+  if ( sim -> calibrating_health )
+    return false;
+
+  return ( sim -> iterations <= 1 && sim -> current_iteration == 0 ) ||
+         ( sim -> iterations > 1 && sim -> current_iteration == 1 );
+}
+
+// player_t::sequence_recording =============================================
+
+bool player_t::sequence_recording() const
+{
+  if ( sequence_sample_iteration() )
+    return true;
+
+  // Sequences of worker threads refer to actors that do not outlive the merge
+  return sim -> action_sequence_samples && sim -> thread_index == 0 && ! sim -> calibrating_health;
+}
+
+// player_t::sequence_add_wait ==============================================
+
 void player_t::sequence_add_wait( const timespan_t& amount, const timespan_t& ts )
 {
-  // Collect iteration#1 data, for log/debug/iterations==1 simulation iteration#0 data
-  if ( ( sim -> iterations <= 1 && sim -> current_iteration == 0 ) ||
-       ( sim -> iterations > 1 && sim -> current_iteration == 1 ) )
+  if ( ! in_combat || ! sequence_recording() )
+    return;
+
+  player_collected_data_t::action_sequence_t& seq = collected_data.action_sequence_recording;
+  if ( seq.size() <= sim -> expected_max_time() * 2.0 + 3.0 )
   {
-    if ( collected_data.action_sequence.size() <= sim -> expected_max_time() * 2.0 + 3.0 )
-    {
-      if ( in_combat )
-      {
-        if ( collected_data.action_sequence.size() && collected_data.action_sequence.back() -> wait_time > timespan_t::zero() )
-          collected_data.action_sequence.back() -> wait_time += amount;
-        else
-          collected_data.action_sequence.push_back( new player_collected_data_t::action_sequence_data_t( ts, amount, this ) );
-      }
-    }
+    if ( ! seq.empty() && seq.entries.back().wait_time > timespan_t::zero() )
+      seq.entries.back().wait_time += amount;
     else
-    {
-      assert( false && "Collected too much action sequence data."
-      "This means there is a serious overflow of executed actions in the first iteration, which should be fixed." );
-    }
+      seq.add( nullptr, nullptr, ts, amount, *this );
+  }
+  else
+  {
+    assert( false && "Collected too much action sequence data."
+    "This means there is a serious overflow of executed actions in the first iteration, which should be fixed." );
   }
 }
 
+// player_t::sequence_add ===================================================
+
 void player_t::sequence_add( const action_t* a, const player_t* target, const timespan_t& ts )
 {
-  if ( a -> action_list )
+  if ( ! a -> action_list )
+    return;
+
+  if ( ! in_combat )
   {
-    // Collect iteration#1 data, for log/debug/iterations==1 simulation iteration#0 data
-    if ( ( a -> sim -> iterations <= 1 && a -> sim -> current_iteration == 0 ) ||
-         ( a -> sim -> iterations > 1 && a -> sim -> current_iteration == 1 ) )
-    {
-      if ( collected_data.action_sequence.size() <= sim -> expected_max_time() * 2.0 + 3.0 )
-      {
-        if ( in_combat )
-          collected_data.action_sequence.push_back( new player_collected_data_t::action_sequence_data_t( a, target, ts, this ) );
-        else
-          collected_data.action_sequence_precombat.push_back( new player_collected_data_t::action_sequence_data_t( a, target, ts, this ) );
-      }
-      else
-      {
-        assert( false && "Collected too much action sequence data."
-        "This means there is a serious overflow of executed actions in the first iteration, which should be fixed." );
-      }
-    }
+    if ( sequence_sample_iteration() )
+      collected_data.action_sequence_precombat.add( a, target, ts, timespan_t::zero(), *this );
+    return;
   }
-};
+
+  if ( ! sequence_recording() )
+    return;
+
+  player_collected_data_t::action_sequence_t& seq = collected_data.action_sequence_recording;
+  if ( seq.size() <= sim -> expected_max_time() * 2.0 + 3.0 )
+  {
+    seq.add( a, target, ts, timespan_t::zero(), *this );
+  }
+  else
+  {
+    assert( false && "Collected too much action sequence data."
+    "This means there is a serious overflow of executed actions in the first iteration, which should be fixed." );
+  }
+}
+
+// player_t::sequence_end ===================================================
+
+void player_t::sequence_end()
+{
+  player_collected_data_t& cd = collected_data;
+  player_collected_data_t::action_sequence_t& seq = cd.action_sequence_recording;
+  if ( seq.empty() )
+    return;
+
+  if ( sequence_sample_iteration() )
+    cd.action_sequence = seq;
+
+  if ( sim -> action_sequence_samples && sim -> thread_index == 0 && ! sim -> calibrating_health )
+  {
+    double length = iteration_fight_length.total_seconds();
+    seq.value = length > 0 ? iteration_dmg / length : 0;
+
+    cd.action_sequence_value_sum += seq.value;
+    cd.action_sequence_value_count++;
+    double mean = cd.action_sequence_value_sum / cd.action_sequence_value_count;
+
+    if ( cd.action_sequence_min.empty() || seq.value < cd.action_sequence_min.value )
+      cd.action_sequence_min = seq;
+    if ( cd.action_sequence_max.empty() || seq.value > cd.action_sequence_max.value )
+      cd.action_sequence_max = seq;
+    if ( cd.action_sequence_mean.empty() ||
+         std::fabs( seq.value - mean ) < std::fabs( cd.action_sequence_mean.value - mean ) )
+      cd.action_sequence_mean = seq;
+  }
+
+  seq.clear();
+}
 
 // player_t::combat_begin ===================================================
 
@@ -3614,7 +3695,7 @@ void player_t::datacollection_end()
     collected_data.health_changes_tmi.timeline_normalized.add( sim -> current_time(), 0.0 );
   }
   collected_data.collect_data( *this );
-
+  sequence_end();
 
   range::for_each( buff_list, std::mem_fn(&buff_t::datacollection_end ) );
 
@@ -3872,6 +3953,7 @@ void player_t::reset()
 
   last_cast = timespan_t::zero();
   gcd_ready = timespan_t::zero();
+  next_timeline_sample = timespan_t::max();
 
   cache.invalidate_all();
 
@@ -4128,6 +4210,12 @@ void player_t::arise()
     sim -> player_non_sleeping_list.push_back( this );
   }
 
+  // Enemies always have a health timeline, friendly actors only a primary
+  // resource one
+  if ( sim -> collect_timelines && ( is_enemy() || primary_resource() != RESOURCE_NONE ) )
+    next_timeline_sample = std::max( timespan_t::from_seconds( 1 ),
+                                     timespan_t::from_seconds( std::ceil( sim -> current_time().total_seconds() ) ) );
+
   if ( has_foreground_actions( *this ) )
     schedule_ready();
 
@@ -4164,6 +4252,9 @@ void player_t::demise()
   if ( sim -> log )
     sim -> out_log.printf( "%s demises.. Spawn Index=%u", name(), actor_spawn_index );
 
+  sample_timelines();
+  next_timeline_sample = timespan_t::max();
+
   /* Do not reset spawn index, because the player can still have damaging events ( dots ) which
    * need to be associated with eg. resolve Diminishing Return list.
    */
@@ -4394,35 +4485,40 @@ void player_t::regen( timespan_t periodicity )
 
 void player_t::collect_resource_timeline_information()
 {
-  for (auto & elem : collected_data.resource_timelines)
+  while ( next_timeline_sample <= sim -> current_time() )
   {
-    elem.timeline.add( sim -> current_time(),
-        resources.current[ elem.type ] );
-  }
+    for (auto & elem : collected_data.resource_timelines)
+    {
+      elem.timeline.add( next_timeline_sample,
+          resources.current[ elem.type ] );
+    }
 
-  for (auto & elem : collected_data.stat_timelines)
-  {
-    switch ( elem.type )
+    for (auto & elem : collected_data.stat_timelines)
     {
-      case STAT_STRENGTH:
-        elem.timeline.add( sim -> current_time(), cache.strength() );
-        break;
-      case STAT_AGILITY:
-        elem.timeline.add( sim -> current_time(), cache.agility() );
-        break;
-      case STAT_INTELLECT:
-        elem.timeline.add( sim -> current_time(), cache.intellect() );
-        break;
-      case STAT_SPELL_POWER:
-        elem.timeline.add( sim -> current_time(), cache.spell_power( SCHOOL_NONE ) );
-        break;
-      case STAT_ATTACK_POWER:
-        elem.timeline.add( sim -> current_time(), cache.attack_power() );
-        break;
-      default:
-        elem.timeline.add( sim -> current_time(), 0 );
-        break;
+      switch ( elem.type )
+      {
+        case STAT_STRENGTH:
+          elem.timeline.add( next_timeline_sample, cache.strength() );
+          break;
+        case STAT_AGILITY:
+          elem.timeline.add( next_timeline_sample, cache.agility() );
+          break;
+        case STAT_INTELLECT:
+          elem.timeline.add( next_timeline_sample, cache.intellect() );
+          break;
+        case STAT_SPELL_POWER:
+          elem.timeline.add( next_timeline_sample, cache.spell_power( SCHOOL_NONE ) );
+          break;
+        case STAT_ATTACK_POWER:
+          elem.timeline.add( next_timeline_sample, cache.attack_power() );
+          break;
+        default:
+          elem.timeline.add( next_timeline_sample, 0 );
+          break;
+      }
     }
+
+    next_timeline_sample += timespan_t::from_seconds( 1 );
   }
 }
 
@@ -4439,6 +4535,8 @@ double player_t::resource_loss( resource_e resource_type,
   if ( current.sleeping )
     return 0.0;
 
+  sample_timelines();
+
   if ( resource_type == primary_resource() )
     uptimes.primary_resource_cap -> update( false, sim -> current_time() );
 
@@ -4457,6 +4555,9 @@ double player_t::resource_loss( resource_e resource_type,
     iteration_resource_lost[ resource_type ] += actual_amount;
   }
 
+  if ( resource_type == RESOURCE_HEALTH )
+    health_changed();
+
   if ( source )
   {
     source -> add( resource_type, actual_amount * -1, ( amount - actual_amount ) * -1 );
@@ -4470,6 +4571,8 @@ double player_t::resource_loss( resource_e resource_type,
   if ( sim -> debug )
     sim -> out_debug.printf( "Player %s loses %.2f (%.2f) %s. health pct: %.2f (%.0f/%.0f)",
                    name(), actual_amount, amount, util::resource_type_string( resource_type ), health_percentage(), resources.current[ resource_type ], resources.max[ resource_type ] );
+  if ( sim -> event_trace.active )
+    sim -> event_trace.resource_loss( *this, resource_type, actual_amount, amount );
 
   return actual_amount;
 }
@@ -4484,12 +4587,17 @@ double player_t::resource_gain( resource_e resource_type,
   if ( current.sleeping )
     return 0.0;
 
+  sample_timelines();
+
   double actual_amount = std::min( amount, resources.max[ resource_type ] - resources.current[ resource_type ] );
 
   if ( actual_amount > 0.0 )
   {
     resources.current[ resource_type ] += actual_amount;
     iteration_resource_gained [ resource_type ] += actual_amount;
+
+    if ( resource_type == RESOURCE_HEALTH )
+      health_changed();
   }
 
   if ( resource_type == primary_resource() && resources.max[ resource_type ] <= resources.current[ resource_type ] )
@@ -4508,6 +4616,9 @@ double player_t::resource_gain( resource_e resource_type,
                    source ? source -> name() : action ? action -> name() : "unknown",
                    resources.current[ resource_type ], resources.max[ resource_type ] );
   }
+  if ( sim -> event_trace.active )
+    sim -> event_trace.resource_gain( *this, resource_type, actual_amount, amount,
+                                      source ? source -> name() : action ? action -> name() : "unknown" );
 
   return actual_amount;
 }
@@ -4529,6 +4640,8 @@ bool player_t::resource_available( resource_e resource_type,
 
 void player_t::recalculate_resource_max( resource_e resource_type )
 {
+  sample_timelines();
+
   resources.max[ resource_type ] = resources.base[ resource_type ] * resources.base_multiplier[ resource_type ] +
                                    gear.resource[ resource_type ] +
                                    enchant.resource[ resource_type ] +
@@ -4551,6 +4664,9 @@ void player_t::recalculate_resource_max( resource_e resource_type )
   resources.max[ resource_type ] += resources.temporary[ resource_type ];
   // Sanity check on current values
   resources.current[ resource_type ] = std::min( resources.current[ resource_type ], resources.max[ resource_type] );
+
+  if ( resource_type == RESOURCE_HEALTH )
+    health_changed();
 }
 
 // player_t::primary_role ===================================================
@@ -5063,7 +5179,7 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
      std::vector<int> absorb_priority; is a vector that contains the sequencing for
      high priority (tank) absorbs and instant absorbs, by spell ID. High priority and
      instant absorbs MUST be pushed into this array inside init_absorb_priority() to
-     function.
+     function. init_absorb_sequence() resolves it into absorb_sequence afterwards.
    
   */
 
@@ -5073,17 +5189,16 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
 
   if ( ! ( p.absorb_buff_list.empty() && p.instant_absorb_list.empty() ) )
   {
-    /* First, handle high priority absorbs and instant absorbs. These absorbs should 
-       obey the sequence laid out in absorb_priority. To achieve this, we loop through
-       absorb_priority in order, then find and apply the appropriate high priority
-       or instant absorb. */
-    for ( size_t i = 0; i < p.absorb_priority.size(); i++ )
+    /* First, handle high priority absorbs and instant absorbs. These absorbs should
+       obey the sequence laid out in absorb_priority. High priority absorb buffs lead
+       absorb_buff_list in that same order, so each entry of the sequence only needs
+       to look at the active high priority buffs after the previous match. */
+    std::vector<absorb_buff_t*>& list = p.absorb_buff_list;
+    size_t next = 0;
+    for ( size_t i = 0; i < p.absorb_sequence.size(); i++ )
     {
-      // Check for the absorb ID in instantaneous absorbs first, since its low cost.
-      if ( p.instant_absorb_list.find( p.absorb_priority[ i ] ) != p.instant_absorb_list.end() )
+      if ( instant_absorb_t* ab = p.absorb_sequence[ i ].second )
       {
-        instant_absorb_t* ab = p.instant_absorb_list[ p.absorb_priority[ i ] ];
-
         // eligibility is handled in the instant absorb's handler
         double absorbed = ab -> consume( s );
 
@@ -5096,14 +5211,11 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
       }
       else
       {
-        // Check for the absorb ID in high priority absorbs.
-        for ( size_t j = 0; j < p.absorb_buff_list.size(); j++ )
+        for ( size_t j = next; j < list.size() && list[ j ] -> high_priority; j++ )
         {
-          if ( p.absorb_buff_list[ j ] -> data().id() == p.absorb_priority[ i ] )
+          if ( list[ j ] -> data().id() == p.absorb_sequence[ i ].first )
           {
-            absorb_buff_t* ab = p.absorb_buff_list[ j ];
-
-            assert( ab -> high_priority && "Absorb buff with set priority is not flagged for high priority." );
+            absorb_buff_t* ab = list[ j ];
 
             if ( ( ( ab -> eligibility && ab -> eligibility( s ) ) // Use the eligibility function if there is one
               || ( school == SCHOOL_NONE || dbc::is_school( ab -> absorb_school, school ) ) ) // Otherwise check by school
@@ -5125,11 +5237,12 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
             if ( ab -> current_value <= 0 )
               ab -> expire();
 
+            next = j;
             break;
           }
         }
       }
-       
+
       if ( s -> result_amount <= 0 )
       {
         assert( s -> result_amount == 0 );
@@ -5139,17 +5252,18 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
 
     // Second, we handle any low priority absorbs. These absorbs obey the rule of "smallest first".
 
-    // Sort the absorbs by size, then we can loop through them in order.
-    std::sort( p.absorb_buff_list.begin(), p.absorb_buff_list.end(), absorb_sort );
-    size_t offset = 0;
+    // Sort the low priority absorbs by size, then we can loop through them in order.
+    auto low = std::find_if( list.begin(), list.end(), []( const absorb_buff_t* ab ) { return ! ab -> high_priority; } );
+    if ( list.end() - low > 1 )
+      std::stable_sort( low, list.end(), absorb_sort );
+    size_t offset = low - list.begin();
 
-    while ( offset < p.absorb_buff_list.size() && s -> result_amount > 0 && ! p.absorb_buff_list.empty() )
+    while ( offset < list.size() && s -> result_amount > 0 )
     {
-      absorb_buff_t* ab = p.absorb_buff_list[ offset ];
+      absorb_buff_t* ab = list[ offset ];
 
-      /* Check absorb eligbility by school and custom eligibility function, skipping high priority
-         absorbs since those have already been processed above. */
-      if ( ab -> high_priority || ( ab -> eligibility && ! ab -> eligibility( s ) ) // Use the eligibility function if there is one
+      // Check absorb eligbility by school and custom eligibility function
+      if ( ( ab -> eligibility && ! ab -> eligibility( s ) ) // Use the eligibility function if there is one
         || ( school != SCHOOL_NONE && ! dbc::is_school( ab -> absorb_school, school ) ) ) // Otherwise check by school
       {
         offset++;
@@ -5187,7 +5301,7 @@ double account_absorb_buffs( player_t& p, action_state_t* s, school_e school )
       if ( ab -> current_value <= 0 )
       {
         ab -> expire();
-        assert( p.absorb_buff_list.empty() || p.absorb_buff_list[ 0 ] != ab );
+        assert( offset >= list.size() || list[ offset ] != ab );
       }
       else
         offset++;
@@ -8586,6 +8700,14 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
 
     resource_expr_t( const std::string& n, player_t& p, resource_e r ) :
       player_expr_t( n, p ), rt( r ) {}
+
+    // Dynamically regenerating actors only bring their resources up to date
+    // when something reads them
+    void regen()
+    {
+      if ( player.regen_type == REGEN_DYNAMIC )
+        player.do_dynamic_regen();
+    }
   };
 
   std::vector<std::string> splits = util::string_split( name_str, "." );
@@ -8597,7 +8719,16 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
     return 0;
 
   if ( splits.size() == 1 )
-    return make_ref_expr( name_str, resources.current[ r ] );
+  {
+    struct resource_current_expr_t : public resource_expr_t
+    {
+      resource_current_expr_t( const std::string& n, player_t& p, resource_e r ) :
+        resource_expr_t( n, p, r ) {}
+      virtual double evaluate() override
+      { regen(); return player.resources.current[ rt ]; }
+    };
+    return new resource_current_expr_t( name_str, *this, r );
+  }
 
   if ( splits.size() == 2 )
   {
@@ -8608,7 +8739,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
         resource_deficit_expr_t( const std::string& n, player_t& p, resource_e r ) :
           resource_expr_t( n, p, r ) {}
         virtual double evaluate() override
-        { return player.resources.max[ rt ] - player.resources.current[ rt ]; }
+        { regen(); return player.resources.max[ rt ] - player.resources.current[ rt ]; }
       };
       return new resource_deficit_expr_t( name_str, *this, r );
     }
@@ -8626,7 +8757,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           resource_pct_expr_t( const std::string& n, player_t& p, resource_e r  ) :
             resource_expr_t( n, p, r ) {}
           virtual double evaluate() override
-          { return player.resources.pct( rt ) * 100.0; }
+          { regen(); return player.resources.pct( rt ) * 100.0; }
         };
         return new resource_pct_expr_t( name_str, *this, r  );
       }
@@ -9455,9 +9586,7 @@ void player_t::analyze( sim_t& s )
     stats_t* stats = tmp_stats_list[ i ];
     if ( ( stats -> type != STATS_DMG ) == is_hps )
     {
-      size_t j_max = std::min( max_buckets, stats -> timeline_amount.data().size() );
-      for ( size_t j = 0; j < j_max; j++ )
-        collected_data.timeline_dmg.add( j, stats -> timeline_amount.data()[ j ] );
+      collected_data.timeline_dmg.add_rebinned( stats -> timeline_amount, max_buckets );
     }
   }
 
@@ -9590,6 +9719,8 @@ void player_callbacks_t::register_callback( unsigned proc_flags,
   if ( proc_flags2 == 0 )
     proc_flags2 = PF2_LANDED;
 
+  generation++;
+
   for ( proc_types t = PROC1_TYPE_MIN; t < PROC1_TYPE_BLIZZARD_MAX; t++ )
   {
     // If there's no proc-by-X, we don't need to add anything
@@ -10163,51 +10294,94 @@ double player_stat_cache_t::player_heal_multiplier( const action_state_t* s ) co
 
 #endif
 
-player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const action_t* a, const player_t* t, const timespan_t& ts, const player_t* p ) :
-  action( a ), target( t ), time( ts ), wait_time( timespan_t::zero() )
+// player_collected_data_t::action_sequence_t::clear =======================
+
+void player_collected_data_t::action_sequence_t::clear()
+{
+  entries.clear();
+  buffs.clear();
+  resources.clear();
+  range::fill( last_current, -1 );
+  range::fill( last_max, -1 );
+  value = 0;
+}
+
+// player_collected_data_t::action_sequence_t::add =========================
+
+void player_collected_data_t::action_sequence_t::add( const action_t* a, const player_t* t,
+                                                      const timespan_t& ts, const timespan_t& wait,
+                                                      const player_t& p )
 {
-  for ( size_t i = 0; i < p -> buff_list.size(); ++i )
+  assert( p.buff_list.size() <= std::numeric_limits<uint16_t>::max() );
+
+  for ( size_t i = 0; i < p.buff_list.size(); ++i )
   {
-    buff_t* b = p -> buff_list[ i ];
+    buff_t* b = p.buff_list[ i ];
     if ( b -> check() && ! b -> quiet && ! b -> constant )
-      buff_list.push_back( std::make_pair( b, b -> stack() ) );
+      buffs.push_back( std::make_pair( static_cast<uint16_t>( i ), static_cast<uint16_t>( b -> stack() ) ) );
   }
 
-  range::fill( resource_snapshot, -1 );
-  range::fill( resource_max_snapshot, -1 );
-
   for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
   {
-    if ( p -> resources.max[ i ] > 0.0 )
+    double current = -1, max = -1;
+    if ( p.resources.max[ i ] > 0.0 )
+    {
+      current = p.resources.current[ i ];
+      max = p.resources.max[ i ];
+    }
+
+    if ( current != last_current[ i ] || max != last_max[ i ] )
     {
-      resource_snapshot[ i ] = p -> resources.current[ i ];
-      resource_max_snapshot[ i ] = p -> resources.max[ i ];
+      resource_entry_t r = { i, current, max };
+      resources.push_back( r );
+      last_current[ i ] = current;
+      last_max[ i ] = max;
     }
   }
+
+  entry_t e = { a, t, ts, wait, static_cast<uint32_t>( buffs.size() ), static_cast<uint32_t>( resources.size() ) };
+  entries.push_back( e );
 }
 
-player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const timespan_t& ts, const timespan_t& wait, const player_t* p ) :
-  action( 0 ), target( 0 ), time( ts ), wait_time( wait )
+// player_collected_data_t::action_sequence_t::expand ======================
+
+std::vector<player_collected_data_t::action_sequence_data_t>
+player_collected_data_t::action_sequence_t::expand( const player_t& p ) const
 {
-  for ( size_t i = 0; i < p -> buff_list.size(); ++i )
-  {
-    buff_t* b = p -> buff_list[ i ];
-    if ( b -> check() && ! b -> quiet && ! b -> constant )
-      buff_list.push_back( std::make_pair( b, b -> stack() ) );
-  }
+  std::vector<action_sequence_data_t> out;
+  out.reserve( entries.size() );
 
-  range::fill( resource_snapshot, -1 );
-  range::fill( resource_max_snapshot, -1 );
+  std::array<double, RESOURCE_MAX> current, max;
+  range::fill( current, -1 );
+  range::fill( max, -1 );
 
-  for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
+  size_t buff_begin = 0, resource_begin = 0;
+  for ( size_t i = 0; i < entries.size(); ++i )
   {
-    if ( p -> resources.max[ i ] > 0.0 )
-    {
-      resource_snapshot[ i ] = p -> resources.current[ i ];
-      resource_max_snapshot[ i ] = p -> resources.max[ i ];
+    const entry_t& e = entries[ i ];
 
+    for ( size_t j = resource_begin; j < e.resource_end; ++j )
+    {
+      current[ resources[ j ].resource ] = resources[ j ].current;
+      max[ resources[ j ].resource ] = resources[ j ].max;
     }
+    resource_begin = e.resource_end;
+
+    out.push_back( action_sequence_data_t() );
+    action_sequence_data_t& data = out.back();
+    data.action = e.action;
+    data.target = e.target;
+    data.time = e.time;
+    data.wait_time = e.wait_time;
+    data.resource_snapshot = current;
+    data.resource_max_snapshot = max;
+
+    for ( size_t j = buff_begin; j < e.buff_end; ++j )
+      data.buff_list.push_back( std::make_pair( p.buff_list[ buffs[ j ].first ], static_cast<int>( buffs[ j ].second ) ) );
+    buff_begin = e.buff_end;
   }
+
+  return out;
 }
 
 player_collected_data_t::player_collected_data_t( const std::string& player_name, sim_t& s ) :
@@ -10243,6 +10417,8 @@ player_collected_data_t::player_collected_data_t( const std::string& player_name
   stat_timelines(),
   health_changes(),
   health_changes_tmi(),
+  action_sequence_value_sum( 0 ),
+  action_sequence_value_count( 0 ),
   buffed_stats_snapshot()
 { }
 
@@ -10401,61 +10577,64 @@ void player_collected_data_t::print_tmi_debug_csv( const sc_timeline_t* nma, con
   }
 };
 
-double player_collected_data_t::calculate_max_spike_damage( const health_changes_timeline_t& tl, int window )
+namespace { // UNNAMED NAMESPACE
+
+// TMI filtering strength
+const double TMI_D = 10;
+
+// Output iterator for sliding_window_average() that folds each moving average
+// value straight into the exponentially weighted TMI sum and the maximum
+// spike, so no sliding average timeline has to be built per iteration.
+struct tmi_sum_iterator_t : public std::iterator<std::output_iterator_tag, void, void, void, void>
 {
-  double max_spike = 0;
+  struct sum_t
+  {
+    double window, tmi, max_average;
+    bool empty;
+  };
 
-  // declare sliding average timeline
-  sc_timeline_t sliding_average_tl;
+  sum_t* sum;
 
-  // create sliding average timelines from data
-  tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
+  tmi_sum_iterator_t( sum_t& s ) : sum( &s ) {}
 
-  // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
+  tmi_sum_iterator_t& operator*() { return *this; }
+  tmi_sum_iterator_t& operator++() { return *this; }
+  tmi_sum_iterator_t& operator++( int ) { return *this; }
 
-  // extract the max spike size from the sliding average timeline
-  max_spike = *std::max_element( weighted_value.begin(), weighted_value.end() ); // todo: remove weighted_value here
-  max_spike *= window;
+  tmi_sum_iterator_t& operator=( double average )
+  {
+    // average is the moving average (i.e. 1-second), so multiply by window size to get damage in
+    // "window" seconds, and weight it exponentially using filter strength D
+    sum -> tmi += std::exp( TMI_D * ( average * sum -> window ) );
 
-  return max_spike;
-}
+    if ( sum -> empty || average > sum -> max_average )
+      sum -> max_average = average;
+    sum -> empty = false;
 
-double player_collected_data_t::calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p )
+    return *this;
+  }
+};
+
+} // UNNAMED NAMESPACE
+
+double player_collected_data_t::calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p, double* max_spike )
 {
   // The Theck-Meloree Index is a metric that attempts to quantize the smoothness of damage intake.
   // It performs an exponentially-weighted sum of the moving average of damage intake, with larger
   // damage spikes being weighted more heavily. A formal definition of the metric can be found here:
   // http://www.sacredduty.net/theck-meloree-index-standard-reference-document/
 
-  // accumulator
-  double tmi = 0;
-
-  // declare sliding average timeline
-  sc_timeline_t sliding_average_tl;
-
-  // create sliding average timelines from data
-  tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
-
-  // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
+  // The moving average, the TMI sum and the max spike are computed in a single pass over the
+  // normalized health changes; strictly speaking the sum should be sorted for numerical accuracy
+  tmi_sum_iterator_t::sum_t sum = { static_cast<double>( window ), 0, 0, true };
+  sliding_window_average( tl.timeline_normalized.data(), window, tmi_sum_iterator_t( sum ) );
 
   // define constants
-  double D = 10; // filtering strength
   double c2 = 450; // N_0, default fight length for normalization
-  double c1 = 100000 / D; // health scale factor, determines slope of plot
-
-  for (auto & elem : weighted_value)
-  {
-    // weighted_value is the moving average (i.e. 1-second), so multiply by window size to get damage in "window" seconds
-    elem *= window;
+  double c1 = 100000 / TMI_D; // health scale factor, determines slope of plot
 
-    // calculate exponentially-weighted contribution of this data point using filter strength D
-    elem = std::exp( D * elem );
-
-    // add to the TMI total; strictly speaking this should be moved outside the for loop and turned into a sort() followed by a sum for numerical accuracy
-    tmi += elem;
-  }
+  // accumulator
+  double tmi = sum.tmi;
 
   // multiply by vertical offset factor c2
   tmi *= c2;
@@ -10467,9 +10646,22 @@ double player_collected_data_t::calculate_tmi( const health_changes_timeline_t&
   // multiply by health decade scale factor
   tmi *= c1;
 
+  // extract the max spike size from the sliding average
+  if ( max_spike )
+    *max_spike = sum.empty ? 0 : sum.max_average * window;
+
   // if an output file has been defined, write to it
   if ( ! p.tmi_debug_file_str.empty() )
+  {
+    sc_timeline_t sliding_average_tl;
+    tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
+
+    std::vector<double> weighted_value = sliding_average_tl.data();
+    for ( auto& elem : weighted_value )
+      elem = std::exp( TMI_D * ( elem * window ) );
+
     print_tmi_debug_csv( &sliding_average_tl, weighted_value, p );
+  }
 
   return tmi;
 }
@@ -10565,15 +10757,13 @@ void player_collected_data_t::collect_data( const player_t& p )
         // define constants and variables
         int window = (int) std::floor( p.tmi_window / health_changes_tmi.get_bin_size() + 0.5 ); // window size, bin time replaces 1 eventually
 
-        // Standard TMI uses health_changes_tmi, ignoring externals - use health_changes_tmi
-        tmi = calculate_tmi( health_changes_tmi, window, f_length, p );
+        // Standard TMI uses health_changes_tmi, ignoring externals - use health_changes_tmi. Max
+        // spike ignores external heals as well, so it comes out of the same pass.
+        tmi = calculate_tmi( health_changes_tmi, window, f_length, p, &max_spike );
 
         // ETMI includes external healing - use health_changes
         etmi = calculate_tmi( health_changes, window, f_length, p );
 
-        // Max spike uses health_changes_tmi as well, ignores external heals - use health_changes_tmi
-        max_spike = calculate_max_spike_damage( health_changes_tmi, window );
-
   tank_metric = tmi;
       }
     }
@@ -4016,57 +4016,113 @@ static std::string::size_type match_suffix( const std::string& str, const char*
   return offset;
 }
 
-// Find a consumable of a given subtype, see data_enum.hh for type values.
-// Returns 0 if not found.
-const item_data_t* unique_gear::find_consumable( const dbc_t& dbc,
-                                                 const std::string& name,
-                                                 item_subclass_consumable type )
+// Name index for consumables, built on first use. Consumables are indexed by
+// their tokenized name, and potions additionally by their name without the
+// "potion of" prefix and "potion" suffix.
+struct consumable_index_t
 {
-  // Poor man's longest matching prefix!
-  static const char* potion_prefixes[] = { "potion_of_the_", "potion_of_", "potion_", 0 };
-  static const char* potion_suffixes[] = { "_potion", 0 };
+  dbc_name_index_t<const item_data_t, std::string> by_name;
+  dbc_name_index_t<const item_data_t, std::string> by_potion_name;
+  mutex_t mutex;
+#if SC_USE_PTR
+  bool initialized[ 2 ];
+#else
+  bool initialized[ 1 ];
+#endif
 
-  const item_data_t* item = 0;
-  std::string consumable_name;
+  consumable_index_t()
+  { range::fill( initialized, false ); }
 
-  for ( item = dbc::items( maybe_ptr( dbc.ptr ) ); item -> id != 0; item++ )
+  void init( bool ptr )
   {
-    if ( item -> item_class != 0 )
-      continue;
+    // Poor man's longest matching prefix!
+    static const char* potion_prefixes[] = { "potion_of_the_", "potion_of_", "potion_", 0 };
+    static const char* potion_suffixes[] = { "_potion", 0 };
 
-    if ( item -> item_subclass != type )
-      continue;
+    AUTO_LOCK( mutex );
 
-    consumable_name = item -> name;
+    if ( initialized[ maybe_ptr( ptr ) ] )
+      return;
 
-    util::tokenize( consumable_name );
+    for ( const item_data_t* item = dbc::items( ptr ); item -> id != 0; item++ )
+    {
+      if ( item -> item_class != 0 )
+        continue;
 
-    if ( util::str_compare_ci( consumable_name, name ) )
-      break;
+      std::string consumable_name = dbc::item_name( item );
 
-    if ( type == ITEM_SUBCLASS_POTION )
-    {
-      std::string::size_type prefix_offset = match_prefix( consumable_name, potion_prefixes );
-      std::string::size_type suffix_offset = match_suffix( consumable_name, potion_suffixes );
+      util::tokenize( consumable_name );
 
-      if ( prefix_offset == std::string::npos )
-        prefix_offset = 0;
+      by_name.add( ptr, consumable_name, item );
 
-      if ( suffix_offset == std::string::npos )
-        suffix_offset = consumable_name.size();
-      else if ( suffix_offset <= prefix_offset )
-        suffix_offset = consumable_name.size();
+      if ( item -> item_subclass == ITEM_SUBCLASS_POTION )
+      {
+        std::string::size_type prefix_offset = match_prefix( consumable_name, potion_prefixes );
+        std::string::size_type suffix_offset = match_suffix( consumable_name, potion_suffixes );
 
-      std::string parsed_name = consumable_name.substr( prefix_offset, suffix_offset );
-      if ( util::str_compare_ci( name, parsed_name ) )
-        break;
+        if ( prefix_offset == std::string::npos )
+          prefix_offset = 0;
+
+        if ( suffix_offset == std::string::npos )
+          suffix_offset = consumable_name.size();
+        else if ( suffix_offset <= prefix_offset )
+          suffix_offset = consumable_name.size();
+
+        by_potion_name.add( ptr, consumable_name.substr( prefix_offset, suffix_offset ), item );
+      }
+    }
+
+    by_name.sort( ptr );
+    by_potion_name.sort( ptr );
+
+    initialized[ maybe_ptr( ptr ) ] = true;
+  }
+
+  // First item (in client data order) of the given subclass in a range of
+  // index entries
+  static const item_data_t* first_of_type( const dbc_name_index_t<const item_data_t, std::string>& index,
+                                           bool ptr, const std::string& name, item_subclass_consumable type )
+  {
+    auto range = index.find( ptr, name );
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+      if ( it -> second -> item_subclass == type )
+        return it -> second;
     }
+
+    return 0;
   }
+};
 
-  if ( item -> id != 0 )
-    return item;
+static consumable_index_t consumable_index;
 
-  return 0;
+// Find a consumable of a given subtype, see data_enum.hh for type values.
+// Returns 0 if not found.
+const item_data_t* unique_gear::find_consumable( const dbc_t& dbc,
+                                                 const std::string& name,
+                                                 item_subclass_consumable type )
+{
+  bool ptr = maybe_ptr( dbc.ptr );
+
+  consumable_index.init( ptr );
+
+  // Tokenized names are lower case, so a lower cased key gives a case
+  // insensitive match
+  std::string key = name;
+  for ( auto& c : key )
+    c = std::tolower( static_cast<unsigned char>( c ) );
+
+  const item_data_t* item = consumable_index_t::first_of_type( consumable_index.by_name, ptr, key, type );
+
+  if ( type == ITEM_SUBCLASS_POTION )
+  {
+    const item_data_t* potion = consumable_index_t::first_of_type( consumable_index.by_potion_name, ptr, key, type );
+    // Prefer whichever comes first in the client data
+    if ( potion && ( ! item || potion < item ) )
+      item = potion;
+  }
+
+  return item;
 }
 
 const item_data_t* unique_gear::find_item_by_spell( const dbc_t& dbc, unsigned spell_id )
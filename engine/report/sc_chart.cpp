@@ -3605,6 +3605,8 @@ highchart::time_series_t& chart::generate_stats_timeline( highchart::time_series
     area_color = color::school_color( s.action_list[ 0 ] -> school );
 
   ts.add_simple_series( "area", area_color, s.type == STATS_DMG ? "DPS" : "HPS", timeline_aps.data() );
+  if ( timeline_aps.get_bin_size() != 1.0 )
+    ts.set( "plotOptions.area.pointInterval", timeline_aps.get_bin_size() );
   ts.set_mean( util::round( s.portion_aps.mean(), s.player -> sim -> report_precision ) );
 
   return ts;
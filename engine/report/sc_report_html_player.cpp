@@ -789,7 +789,7 @@ void print_html_action_info( report::sc_html_stream& os, unsigned stats_mask, co
     }
     else
     {
-      if ( s.has_direct_amount_results() || s.has_tick_amount_results() )
+      if ( ( s.has_direct_amount_results() || s.has_tick_amount_results() ) && ! s.timeline_amount.data().empty() )
       {
         highchart::time_series_t ts( highchart::build_id( s ), *s.player -> sim );
         chart::generate_stats_timeline( ts, s );
@@ -2114,25 +2114,43 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
 
   if ( ! p.collected_data.action_sequence.empty() )
   {
+    typedef std::vector<player_collected_data_t::action_sequence_data_t> sequence_t;
+    const player_collected_data_t& cd = p.collected_data;
+    sequence_t sequence = cd.action_sequence.expand( p );
+    sequence_t precombat = cd.action_sequence_precombat.expand( p );
+
+    // Iterations sampled with action_sequence_samples=1
+    std::vector<std::pair<std::string, sequence_t> > samples;
+    const player_collected_data_t::action_sequence_t* sampled[] = {
+      &cd.action_sequence_min, &cd.action_sequence_mean, &cd.action_sequence_max };
+    const char* sample_names[] = { "Lowest DPS", "Mean DPS", "Highest DPS" };
+    for ( size_t i = 0; i < 3; ++i )
+    {
+      if ( sampled[ i ] -> empty() )
+        continue;
+
+      std::string title = sample_names[ i ];
+      title += " Sample Sequence (" + util::to_string( sampled[ i ] -> value, 0 ) + " DPS)";
+      samples.push_back( std::make_pair( title, sampled[ i ] -> expand( p ) ) );
+    }
 
     std::vector<std::string> targets;
 
     targets.push_back( "none" );
     targets.push_back( p.target -> name() );
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
+    std::vector<const sequence_t*> all_sequences( 1, &sequence );
+    for ( size_t i = 0; i < samples.size(); ++i )
+      all_sequences.push_back( &samples[ i ].second );
+
+    for ( const sequence_t* seq : all_sequences )
     {
-      if ( ! sequence_data -> action || ! sequence_data -> action -> harmful ) continue;
-      bool found = false;
-      for ( size_t j = 0; j < targets.size(); ++j )
+      for ( const auto& sequence_data : *seq )
       {
-        if ( targets[ j ] == sequence_data -> target -> name() )
-        {
-          found = true;
-          break;
-        }
+        if ( ! sequence_data.action || ! sequence_data.action -> harmful ) continue;
+        if ( range::find( targets, sequence_data.target -> name() ) == targets.end() )
+          targets.push_back( sequence_data.target -> name() );
       }
-      if ( ! found ) targets.push_back( sequence_data -> target -> name() );
     }
 
     // Sample Sequence (text string)
@@ -2161,14 +2179,23 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
 
     os << "</style>\n";
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence_precombat )
+    for ( const auto& sequence_data : precombat )
     {
-      print_html_sample_sequence_string_entry( os, *sequence_data, p, true );
+      print_html_sample_sequence_string_entry( os, sequence_data, p, true );
     }
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
+    for ( const auto& sequence_data : sequence )
     {
-      print_html_sample_sequence_string_entry( os, *sequence_data, p );
+      print_html_sample_sequence_string_entry( os, sequence_data, p );
+    }
+
+    for ( size_t i = 0; i < samples.size(); ++i )
+    {
+      os << "\n<h4>" << samples[ i ].first << "</h4>\n";
+      for ( const auto& sequence_data : samples[ i ].second )
+      {
+        print_html_sample_sequence_string_entry( os, sequence_data, p );
+      }
     }
 
     os << "\n</div>\n"
@@ -2191,14 +2218,14 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
       "<th class=\"center\">buffs</th>\n"
       "</tr>\n");
     
-    for ( const auto& sequence_data : p.collected_data.action_sequence_precombat )
+    for ( const auto& sequence_data : precombat )
     {
-      print_html_sample_sequence_table_entry( os, *sequence_data, p, true );
+      print_html_sample_sequence_table_entry( os, sequence_data, p, true );
     }
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
+    for ( const auto& sequence_data : sequence )
     {
-      print_html_sample_sequence_table_entry( os, *sequence_data, p );
+      print_html_sample_sequence_table_entry( os, sequence_data, p );
     }
 
     // close table
@@ -371,7 +371,7 @@ js::sc_js_t to_json( const player_collected_data_t::action_sequence_data_t& asd
   return node;
 }
 
-js::sc_js_t to_json( const player_collected_data_t& cd )
+js::sc_js_t to_json( const player_collected_data_t& cd, const player_t& p )
 {
   js::sc_js_t node;
   node.set( "fight_length", to_json( cd.fight_length ) );
@@ -433,13 +433,25 @@ js::sc_js_t to_json( const player_collected_data_t& cd )
   node.set( "health_changes", to_json( cd.health_changes ) );
   node.set( "health_changes", to_json( cd.health_changes_tmi ) );
   node.set( "resolve_timeline", to_json( cd.resolve_timeline ) );
-  for ( const auto& asd : cd.action_sequence )
+  for ( const auto& asd : cd.action_sequence.expand( p ) )
   {
-    node.add( "action_sequence", to_json( *asd ) );
+    node.add( "action_sequence", to_json( asd ) );
   }
-  for ( const auto& asd : cd.action_sequence_precombat )
+  for ( const auto& asd : cd.action_sequence_precombat.expand( p ) )
   {
-    node.add( "action_sequence_precombat", to_json( *asd ) );
+    node.add( "action_sequence_precombat", to_json( asd ) );
+  }
+  for ( const auto& asd : cd.action_sequence_min.expand( p ) )
+  {
+    node.add( "action_sequence_min", to_json( asd ) );
+  }
+  for ( const auto& asd : cd.action_sequence_mean.expand( p ) )
+  {
+    node.add( "action_sequence_mean", to_json( asd ) );
+  }
+  for ( const auto& asd : cd.action_sequence_max.expand( p ) )
+  {
+    node.add( "action_sequence_max", to_json( asd ) );
   }
   node.set( "buffed_stats_snapshot", to_json( cd.buffed_stats_snapshot ) );
 
@@ -587,7 +599,7 @@ js::sc_js_t to_json( const player_t& p )
 
   // TODO
 
-  node.set( "collected_data", to_json( p.collected_data ) );
+  node.set( "collected_data", to_json( p.collected_data, p ) );
   // TODO
 
   for ( const auto& buff : p.buff_list )
@@ -675,6 +687,7 @@ js::sc_js_t to_json( const plot_t& o )
   node.set( "dps_plot_iterations", o.dps_plot_iterations );
   node.set( "dps_plot_target_error", o.dps_plot_target_error );
   node.set( "dps_plot_debug", o.dps_plot_debug );
+  node.set( "dps_plot_perturbation", o.dps_plot_perturbation );
   node.set( "dps_plot_positive", o.dps_plot_positive );
   node.set( "dps_plot_negative", o.dps_plot_negative );
   return node;
@@ -776,6 +789,13 @@ js::sc_js_t to_json( const sim_t& sim )
   node.set( "reforge_plot", to_json( *sim.reforge_plot ) );
   node.set( "elapsed_cpu", sim.elapsed_cpu );
   node.set( "elapsed_time", sim.elapsed_time );
+  for ( const auto& phase : sim.init_profile.phases )
+  {
+    js::sc_js_t phase_node;
+    phase_node.set( "name", phase.first );
+    phase_node.set( "seconds", phase.second );
+    node.add( "init_phases", phase_node );
+  }
   node.set( "raid_dps", to_json( sim.raid_dps ) );
   node.set( "total_dmg", to_json( sim.total_dmg ) );
   node.set( "raid_hps", to_json( sim.raid_hps ) );
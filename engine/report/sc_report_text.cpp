@@ -696,6 +696,18 @@ void print_text_performance( FILE* file, sim_t* sim )
                  sim -> iterations * sim -> simulation_length.mean() / sim -> elapsed_cpu,
                  date_str,
                  static_cast<double>( cur_time ) );
+
+  if ( ! sim -> init_profile.phases.empty() )
+  {
+    util::fprintf( file, "Init Phases:\n" );
+    for ( size_t i = 0; i < sim -> init_profile.phases.size(); ++i )
+    {
+      util::fprintf( file, "  %-22s = %.3f\n",
+                     sim -> init_profile.phases[ i ].first.c_str(),
+                     sim -> init_profile.phases[ i ].second );
+    }
+    util::fprintf( file, "\n" );
+  }
 #ifdef EVENT_QUEUE_DEBUG
   double total_p = 0;
 
@@ -463,7 +463,7 @@ void print_xml_player_actions( xml_writer_t & writer, player_t* p )
       }
       else
       {
-        if ( s -> has_direct_amount_results() || s -> has_tick_amount_results() )
+        if ( ( s -> has_direct_amount_results() || s -> has_tick_amount_results() ) && ! s -> timeline_amount.data().empty() )
         {
           highchart::time_series_t ts( highchart::build_id( *s ), s -> player -> sim );
           writer.begin_tag( "chart" );
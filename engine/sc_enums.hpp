@@ -15,8 +15,8 @@ enum regen_type_e
   /**
    * @brief Old resource regeneration model.
    *
-   * Actors regen every 'periodicity' seconds through a single global event.
-   * Default.
+   * Actors regen every 'periodicity' seconds through a single global event,
+   * which only runs if some actor uses this model.
    */
   REGEN_STATIC,
 
@@ -28,7 +28,7 @@ enum regen_type_e
    * affects resource regeneration.
    *
    * See comment on player_t::regen_caches how to define what state changes
-   * affect resource regneration.
+   * affect resource regneration. Default.
    */
   REGEN_DYNAMIC,
 
@@ -7,72 +7,50 @@
 
 namespace { // UNNAMED NAMESPACE
 
-struct recharge_event_t : event_t
+struct ready_trigger_event_t : public player_event_t
 {
-  cooldown_t* cooldown_;
-  action_t* action_;
-  timespan_t duration_, event_duration_;
-
-  recharge_event_t( cooldown_t* cd, action_t* a, timespan_t base_duration ) :
-    event_t( cd -> sim ), cooldown_( cd ), action_( a ),
-    duration_( base_duration ),
-    event_duration_( cooldown_t::cooldown_duration( cd, base_duration, a ) )
+  cooldown_t* cooldown;
+
+  ready_trigger_event_t( player_t& p, cooldown_t* cd, timespan_t delta_time ) :
+    player_event_t( p ),
+    cooldown( cd )
   {
-    add_event( event_duration_ );
+    add_event( delta_time );
   }
   virtual const char* name() const override
-  { return "recharge_event"; }
-  recharge_event_t( cooldown_t* cd, action_t* a, timespan_t event_duration, timespan_t base_duration ) :
-    event_t( *cd -> player ), cooldown_( cd ), action_( a ),
-    duration_( base_duration ), event_duration_( event_duration )
-  {
-    add_event( event_duration_ );
-  }
-  virtual void execute() override
+  { return "ready_trigger_event"; }
+  void execute() override
   {
-    assert( cooldown_ -> current_charge < cooldown_ -> charges );
-    cooldown_ -> current_charge++;
-    cooldown_ -> ready = cooldown_t::ready_init();
-
-    if ( cooldown_ -> current_charge < cooldown_ -> charges )
-    {
-      cooldown_ -> recharge_event = new ( sim() ) recharge_event_t( cooldown_, action_, duration_ );
-    }
-    else
-    {
-      cooldown_ -> recharge_event = nullptr;
-      cooldown_ -> last_charged = sim().current_time();
-    }
+    cooldown -> ready_trigger_event = nullptr;
 
-    if ( sim().debug )
-      sim().out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, next=%.3f, ready=%.3f",
-        action_ -> player -> name(), cooldown_ -> name_str.c_str(), cooldown_ -> current_charge, cooldown_ -> charges,
-        cooldown_ -> recharge_event ? cooldown_ -> recharge_event -> occurs().total_seconds() : 0,
-        cooldown_ -> ready.total_seconds() );
+    // Keep waking the actor up for every charge that regenerates
+    cooldown -> update_charges();
+    if ( cooldown -> recharging() )
+      cooldown -> schedule_ready_trigger();
 
-    if ( action_ )
-    {
-      action_ -> player -> trigger_ready();
-    }
+    p() -> trigger_ready();
   }
 };
 
-struct ready_trigger_event_t : public player_event_t
+struct recharge_event_t : public event_t
 {
   cooldown_t* cooldown;
 
-  ready_trigger_event_t( player_t& p, cooldown_t* cd ) :
-    player_event_t( p ),
+  recharge_event_t( cooldown_t* cd, timespan_t delta_time ) :
+    event_t( cd -> sim ),
     cooldown( cd )
   {
-    add_event( cd -> ready - sim().current_time() );
+    add_event( delta_time );
   }
   virtual const char* name() const override
-  { return "ready_trigger_event"; }
+  { return "recharge_event"; }
   void execute() override
   {
-    cooldown -> ready_trigger_event = nullptr;
-    p() -> trigger_ready();
+    cooldown -> recharge_event = nullptr;
+
+    // Credit the charge while the state the next cycle depends on is current
+    cooldown -> update_charges();
+    cooldown -> schedule_recharge_event();
   }
 };
 
@@ -112,8 +90,12 @@ cooldown_t::cooldown_t( const std::string& n, player_t& p ) :
   reset_react( timespan_t::zero() ),
   charges( 1 ),
   current_charge( 1 ),
-  recharge_event( nullptr ),
+  recharge_end( timespan_t::zero() ),
+  recharge_duration( timespan_t::zero() ),
+  recharge_base( timespan_t::min() ),
+  recharge_action( nullptr ),
   ready_trigger_event( nullptr ),
+  recharge_event( nullptr ),
   last_start( timespan_t::zero() ),
   last_charged( timespan_t::zero() ),
   recharge_multiplier( 1.0 )
@@ -128,13 +110,79 @@ cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
   reset_react( timespan_t::zero() ),
   charges( 1 ),
   current_charge( 1 ),
-  recharge_event( nullptr ),
+  recharge_end( timespan_t::zero() ),
+  recharge_duration( timespan_t::zero() ),
+  recharge_base( timespan_t::min() ),
+  recharge_action( nullptr ),
   ready_trigger_event( nullptr ),
+  recharge_event( nullptr ),
   last_start( timespan_t::zero() ),
   last_charged( timespan_t::zero() ),
   recharge_multiplier( 1.0 )
 {}
 
+// cooldown_t::update_charges ===============================================
+
+void cooldown_t::update_charges()
+{
+  if ( ! recharging() || recharge_end > sim.current_time() )
+    return;
+
+  while ( current_charge < charges && recharge_end <= sim.current_time() )
+  {
+    current_charge++;
+
+    if ( current_charge < charges )
+    {
+      recharge_duration = cooldown_duration( this, recharge_base, recharge_action );
+      recharge_end += recharge_duration;
+    }
+    else
+      last_charged = recharge_end;
+
+    if ( sim.debug )
+      sim.out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, next=%.3f",
+        player ? player -> name() : "sim", name_str.c_str(), current_charge, charges,
+        current_charge < charges ? recharge_end.total_seconds() : 0 );
+  }
+
+  ready = ready_init();
+}
+
+// cooldown_t::schedule_recharge_event ======================================
+
+void cooldown_t::schedule_recharge_event()
+{
+  event_t::cancel( recharge_event );
+
+  if ( ! recharging() )
+    return;
+
+  // Recharge durations that only change through the recharge multiplier can
+  // be computed whenever the charges are looked at
+  if ( ! sim.cooldown_recharge_events &&
+       ( ! recharge_action || ! recharge_action -> dynamic_cooldown_reduction ) )
+    return;
+
+  recharge_event = new ( sim ) recharge_event_t( this,
+      std::max( recharge_end - sim.current_time(), timespan_t::zero() ) );
+}
+
+// cooldown_t::schedule_ready_trigger =======================================
+
+void cooldown_t::schedule_ready_trigger()
+{
+  if ( ! player || player -> ready_type != READY_TRIGGER )
+    return;
+
+  event_t::cancel( ready_trigger_event );
+
+  // Charged cooldowns wake the actor up when the next charge regenerates
+  timespan_t at = recharging() ? recharge_end : ready;
+  ready_trigger_event = new ( sim ) ready_trigger_event_t( *player, this,
+      std::max( at - sim.current_time(), timespan_t::zero() ) );
+}
+
 void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 {
   // Normal cooldown, just adjust as we see fit
@@ -150,63 +198,57 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
     // Still some time left, adjust ready
     else
       ready += amount;
+    return;
   }
+
   // Charge-based cooldown
-  else if ( current_charge < charges )
+  update_charges();
+  if ( ! recharging() )
+    return;
+
+  // Remaining time on the current recharge cycle
+  timespan_t remains = recharge_end - sim.current_time() + amount;
+
+  // Didnt recharge a charge, the cycle just ends sooner
+  if ( remains > timespan_t::zero() )
   {
-    // Remaining time on the recharge event
-    timespan_t remains = recharge_event -> remains() + amount;
+    recharge_end += amount;
 
-    // Didnt recharge a charge, just recreate the recharge event to occur
-    // sooner
-    if ( remains > timespan_t::zero() )
-    {
-      recharge_event_t* event = debug_cast<recharge_event_t*>( recharge_event );
-      action_t* a = event -> action_;
-      timespan_t duration_ = event -> duration_;
-      event_t::cancel( recharge_event );
-      recharge_event = new ( sim ) recharge_event_t( this, a, remains, duration_ );
-
-      // If we have no charges, adjust ready time to the new occurrence time
-      // of the recharge event, plus a millisecond
-      if ( current_charge == 0 )
-        ready += amount;
-
-      if ( sim.debug )
-        sim.out_debug.printf( "%s recharge cooldown %s adjustment=%.3f, remains=%.3f, occurs=%.3f, ready=%.3f",
-          player -> name(), name_str.c_str(), amount.total_seconds(), remains.total_seconds(),
-          recharge_event -> occurs().total_seconds(), ready.total_seconds() );
-    }
-    // Recharged a charge
-    else
-    {
-      reset( require_reaction );
-      // Excess time adjustment goes to the next recharge event, if we didnt
-      // max out on charges (recharge_event is still present after reset()
-      // call)
-      if ( remains < timespan_t::zero() && recharge_event )
-      {
-        recharge_event_t* event = debug_cast<recharge_event_t*>( recharge_event );
-        timespan_t duration_ = event -> duration_;
-        action_t* a = event -> action_;
-        event_t::cancel( recharge_event );
+    // If we have no charges, adjust ready time to the new end of the cycle
+    if ( current_charge == 0 )
+      ready = recharge_end;
 
-        // Note, the next recharge cycle uses the previous recharge cycle's
-        // base duration, if overridden
-        timespan_t new_duration = cooldown_duration( this, duration_, a );
-        new_duration += remains;
+    schedule_ready_trigger();
+    schedule_recharge_event();
 
-        recharge_event = new ( sim ) recharge_event_t( this, a, new_duration, duration_ );
-      }
+    if ( sim.debug )
+      sim.out_debug.printf( "%s recharge cooldown %s adjustment=%.3f, remains=%.3f, occurs=%.3f, ready=%.3f",
+        player -> name(), name_str.c_str(), amount.total_seconds(), remains.total_seconds(),
+        recharge_end.total_seconds(), ready.total_seconds() );
+  }
+  // Recharged a charge
+  else
+  {
+    reset( require_reaction );
 
-      if ( sim.debug )
-      {
-        sim.out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, reminder=%.3f, next=%.3f, ready=%.3f",
-          player -> name(), name_str.c_str(), current_charge, charges,
-          remains.total_seconds(),
-          recharge_event ? recharge_event -> occurs().total_seconds() : 0,
-          ready.total_seconds() );
-      }
+    // Excess time adjustment goes to the next recharge cycle, if we didnt max
+    // out on charges. Note, the next recharge cycle uses the previous recharge
+    // cycle's base duration, if overridden
+    if ( remains < timespan_t::zero() && recharging() )
+    {
+      recharge_duration = cooldown_duration( this, recharge_base, recharge_action );
+      recharge_end = sim.current_time() + recharge_duration + remains;
+      schedule_ready_trigger();
+      schedule_recharge_event();
+    }
+
+    if ( sim.debug )
+    {
+      sim.out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, reminder=%.3f, next=%.3f, ready=%.3f",
+        player -> name(), name_str.c_str(), current_charge, charges,
+        remains.total_seconds(),
+        recharging() ? recharge_end.total_seconds() : 0,
+        ready.total_seconds() );
     }
   }
 }
@@ -219,13 +261,19 @@ void cooldown_t::reset_init()
   reset_react = timespan_t::zero();
 
   current_charge = charges;
+  recharge_end = timespan_t::zero();
+  recharge_duration = timespan_t::zero();
+  recharge_base = timespan_t::min();
+  recharge_action = nullptr;
 
-  recharge_event = nullptr;
   ready_trigger_event = nullptr;
+  recharge_event = nullptr;
 }
 
 void cooldown_t::reset( bool require_reaction )
 {
+  update_charges();
+
   bool was_down = down();
   ready = ready_init();
   if ( last_start > sim.current_time() )
@@ -245,10 +293,15 @@ void cooldown_t::reset( bool require_reaction )
   }
   if ( current_charge == charges )
   {
-    event_t::cancel( recharge_event );
     last_charged = sim.current_time();
   }
   event_t::cancel( ready_trigger_event );
+  // The current recharge cycle carries on
+  if ( recharging() )
+  {
+    schedule_ready_trigger();
+  }
+  schedule_recharge_event();
   if ( player )
   {
     player -> trigger_ready();
@@ -276,28 +329,32 @@ void cooldown_t::start( action_t* action, timespan_t _override, timespan_t delay
     event_duration += delay;
   }
 
-  // Normal cooldowns have charges = 0 or 1, and do not use the event system to
-  // trigger ready status (for efficiency reasons). Charged cooldowns recharge
-  // through the event system.
+  // Normal cooldowns have charges = 0 or 1 and are ready when "ready" is
+  // reached. Charged cooldowns recharge one cycle after another, which is
+  // accounted for lazily in update_charges().
   if ( charges > 1 )
   {
+    update_charges();
+
     last_charged = timespan_t::zero();
 
     assert( current_charge > 0 );
     current_charge--;
 
-    // Begin a recharge event
-    if ( ! recharge_event )
+    // Begin a recharge cycle
+    if ( current_charge == charges - 1 )
     {
-      recharge_event = new ( sim ) recharge_event_t( this, action, event_duration, _override );
+      recharge_action = action;
+      recharge_base = _override;
+      recharge_duration = event_duration;
+      recharge_end = sim.current_time() + event_duration;
     }
-    // No charges left, the cooldown won't be ready until a recharge event
-    // occurs. Note, ready still needs to be properly set as it ultimately
+    // No charges left, the cooldown won't be ready until the current recharge
+    // cycle ends. Note, ready still needs to be properly set as it ultimately
     // controls whether a cooldown is "up".
-    else if ( current_charge == 0 )
+    if ( current_charge == 0 )
     {
-      assert( recharge_event );
-      ready = recharge_event -> occurs() + timespan_t::from_millis( 1 );
+      ready = recharge_end;
     }
   }
   else
@@ -308,8 +365,8 @@ void cooldown_t::start( action_t* action, timespan_t _override, timespan_t delay
   }
 
   assert( player );
-  if ( player -> ready_type == READY_TRIGGER )
-    ready_trigger_event = new ( sim ) ready_trigger_event_t( *player, this );
+  schedule_ready_trigger();
+  schedule_recharge_event();
 }
 
 void cooldown_t::start( timespan_t _override, timespan_t delay )
@@ -321,7 +378,23 @@ void cooldown_t::set_recharge_multiplier( double v )
 {
   assert( v >= 0.0 && "Cooldown recharge multiplier should probably not be negative." );
 
-  if ( up() )
+  update_charges();
+
+  if ( recharging() )
+  {
+    // Scale what is left of the current recharge cycle
+    timespan_t remains = recharge_end - sim.current_time();
+    recharge_end += remains * ( v / recharge_multiplier - 1.0 );
+    recharge_duration *= v / recharge_multiplier;
+    recharge_multiplier = v;
+
+    if ( current_charge == 0 )
+      ready = recharge_end;
+
+    schedule_ready_trigger();
+    schedule_recharge_event();
+  }
+  else if ( up() )
   {
     // Cooldown not active, just set the recharge multiplier.
     recharge_multiplier = v;
@@ -344,24 +417,21 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
   else if ( name_str == "up" )
     return make_mem_fn_expr( name_str, *this, &cooldown_t::up );
   else if ( name_str == "charges" )
-    return make_ref_expr( name_str, current_charge );
+    return make_mem_fn_expr( name_str, *this, &cooldown_t::available_charges );
   else if ( name_str == "charges_fractional" )
   {
     struct charges_fractional_expr_t : public expr_t
     {
-      const cooldown_t* cd;
-      charges_fractional_expr_t( const cooldown_t* c ) :
+      cooldown_t* cd;
+      charges_fractional_expr_t( cooldown_t* c ) :
         expr_t( "charges_fractional" ), cd( c )
       { }
 
       virtual double evaluate() override
       {
-        double charges = cd -> current_charge;
-        if ( cd -> recharge_event )
-        {
-          recharge_event_t* re = debug_cast<recharge_event_t*>( cd -> recharge_event );
-          charges += 1 - ( re -> remains() / re -> event_duration_ );
-        }
+        double charges = cd -> available_charges();
+        if ( cd -> recharging() )
+          charges += 1 - ( ( cd -> recharge_end - cd -> sim.current_time() ) / cd -> recharge_duration );
         return charges;
       }
     };
@@ -371,15 +441,16 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
   {
     struct recharge_time_expr_t : public expr_t
     {
-      const cooldown_t* cd;
-      recharge_time_expr_t( const cooldown_t* c ) :
+      cooldown_t* cd;
+      recharge_time_expr_t( cooldown_t* c ) :
         expr_t( "recharge_time" ), cd( c )
       { }
 
       virtual double evaluate() override
       {
-        if ( cd -> recharge_event )
-          return cd -> recharge_event -> remains().total_seconds();
+        cd -> update_charges();
+        if ( cd -> recharging() )
+          return ( cd -> recharge_end - cd -> sim.current_time() ).total_seconds();
         else
           return cd -> duration.total_seconds();
       }
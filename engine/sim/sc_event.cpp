@@ -38,6 +38,8 @@ void event_t::reschedule( timespan_t new_delta_time )
   if ( _sim.debug )
     _sim.out_debug.printf( "Rescheduling event %s (%d) from %.2f to %.2f",
                 name(), id, time.total_seconds(), reschedule_time.total_seconds() );
+  if ( _sim.event_trace.active )
+    _sim.event_trace.event_reschedule( *this );
 }
 
 // event_t::add_event =======================================================
@@ -237,6 +239,8 @@ void event_manager_t::add_event( event_t* e,
 			     e -> name(), e -> time.total_seconds(),
 			     e -> reschedule_time.total_seconds(),
 			     e -> id );
+  if ( sim -> event_trace.active )
+    sim -> event_trace.event_add( *e );
 
 #if ACTOR_EVENT_BOOKKEEPING
   if ( sim -> debug && e -> actor )
@@ -282,6 +286,8 @@ bool event_manager_t::execute()
     {
       if ( sim -> debug )
         sim -> out_debug.printf( "Canceled event: %s", e -> name() );
+      if ( sim -> event_trace.active )
+        sim -> event_trace.event_canceled( *e );
     }
     else if ( e -> reschedule_time > e -> time )
     {
@@ -292,6 +298,8 @@ bool event_manager_t::execute()
     {
       if ( sim -> debug )
         sim -> out_debug.printf( "Executing event: %s", e -> name() );
+      if ( sim -> event_trace.active )
+        sim -> event_trace.event_execute( *e );
 
       if ( monitor_cpu )
       {
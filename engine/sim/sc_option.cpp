@@ -7,6 +7,7 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #include "util/io.hpp"
 #include "sc_util.hpp"
@@ -481,6 +482,8 @@ protected:
     }
     return false;
   }
+  bool prefix() const override
+  { return true; }
   std::ostream& print( std::ostream& stream ) const override
   {
     for ( map_t::const_iterator it = _ref.begin(), end = _ref.end(); it != end; ++it )
@@ -560,6 +563,21 @@ bool opts::parse( sim_t*                 sim,
   return false;
 }
 
+bool opts::parse( sim_t*                 sim,
+                  const option_list_t&   options,
+                  const std::string&     name,
+                  const std::string&     value )
+{
+  std::vector<size_t> candidates;
+  options.candidates( name, candidates );
+
+  for ( size_t idx : candidates )
+    if ( options[ idx ] -> parse_option( sim, name, value ) )
+      return true;
+
+  return false;
+}
+
 // option_t::parse ==========================================================
 
 void opts::parse( sim_t*                 sim,
@@ -602,6 +620,49 @@ void opts::parse( sim_t*                 sim,
 }
 
 
+// option_list_t::update_index =============================================
+
+void option_list_t::update_index() const
+{
+  // Options are only appended; anything else invalidates the whole index
+  if ( indexed > size() )
+  {
+    name_index.clear();
+    prefix_index.clear();
+    indexed = 0;
+  }
+
+  for ( ; indexed < size(); ++indexed )
+  {
+    const option_t* option = ( *this )[ indexed ].get();
+    if ( option -> prefix_option() )
+      prefix_index.push_back( indexed );
+    else
+      name_index[ option -> name() ].push_back( indexed );
+  }
+}
+
+// option_list_t::candidates ================================================
+
+void option_list_t::candidates( const std::string& name, std::vector<size_t>& out ) const
+{
+  update_index();
+
+  out.clear();
+
+  auto it = name_index.find( name );
+  if ( it == name_index.end() )
+  {
+    out = prefix_index;
+    return;
+  }
+
+  // Merge exact and prefix matches back to list order
+  out.resize( it -> second.size() + prefix_index.size() );
+  std::merge( it -> second.begin(), it -> second.end(),
+              prefix_index.begin(), prefix_index.end(), out.begin() );
+}
+
 // option_db_t::parse_file ==================================================
 
 bool option_db_t::parse_file( FILE* file )
@@ -30,24 +30,50 @@ public:
   virtual ~option_t() { }
   bool parse_option( sim_t* sim , const std::string& n, const std::string& value ) const
   { return parse( sim, n, value ); }
-  std::string name() const
+  const std::string& name() const
   { return _name; }
   std::ostream& print_option( std::ostream& stream ) const
   { return print( stream ); }
+  // True if the option accepts names other than its own, such as "name.key"
+  bool prefix_option() const
+  { return prefix(); }
 protected:
   virtual bool parse( sim_t*, const std::string& name, const std::string& value ) const = 0;
   virtual std::ostream& print( std::ostream& stream ) const = 0;
+  virtual bool prefix() const
+  { return false; }
 private:
   std::string _name;
 };
 
 
+// Option list with a name index. Options are looked up by exact name, and
+// only prefix options (see option_t::prefix_option()) are tried for every
+// name. Options are still tried in the order they were added, so parsing
+// behaves as it does on a plain option vector. The index is brought up to
+// date lazily, as options are only ever appended to the list.
+struct option_list_t : public std::vector<std::unique_ptr<option_t>>
+{
+  option_list_t() : indexed( 0 ) { }
+
+  // Fill "out" with the indices of options that may accept the given name,
+  // in list order
+  void candidates( const std::string& name, std::vector<size_t>& out ) const;
+private:
+  mutable std::unordered_map<std::string, std::vector<size_t>> name_index;
+  mutable std::vector<size_t> prefix_index;
+  mutable size_t indexed;
+
+  void update_index() const;
+};
+
 namespace opts {
 
 typedef std::unordered_map<std::string, std::string> map_t;
 typedef std::function<bool(sim_t*,const std::string&, const std::string&)> function_t;
 typedef std::vector<std::string> list_t;
 bool parse( sim_t*, const std::vector<std::unique_ptr<option_t>>&, const std::string& name, const std::string& value );
+bool parse( sim_t*, const option_list_t&, const std::string& name, const std::string& value );
 void parse( sim_t*, const std::string& context, const std::vector<std::unique_ptr<option_t>>&, const std::string& options_str );
 void parse( sim_t*, const std::string& context, const std::vector<std::unique_ptr<option_t>>&, const std::vector<std::string>& strings );
 }
@@ -35,6 +35,15 @@ bool is_plot_stat( sim_t* sim, stat_e stat )
   return it != sim->player_no_pet_list.end();
 }
 
+/// Progress bar label of a plot point
+std::string plot_phase_str( stat_e stat, double amount )
+{
+  std::stringstream stat_name;
+  stat_name.width( 12 );
+  stat_name << std::left << std::string( util::stat_type_abbrev( stat ) ) + ":";
+  return util::to_string( amount ) + " " + stat_name.str();
+}
+
 }  // UNNAMED NAMESPACE ====================================================
 
 // ==========================================================================
@@ -50,6 +59,7 @@ plot_t::plot_t( sim_t* s )
     dps_plot_iterations( -1 ),
     dps_plot_target_error( 0 ),
     dps_plot_debug( 0 ),
+    dps_plot_perturbation( 0 ),
     current_plot_stat( STAT_NONE ),
     num_plot_stats( 0 ),
     remaining_plot_stats( 0 ),
@@ -160,6 +170,55 @@ void plot_t::analyze_stats()
       end   = -start;
     }
 
+    // When asked to, and without a target error, every point runs the same
+    // number of iterations, so all of them can share one sim that has its
+    // players' stats perturbed in place.
+    std::unique_ptr<sim_t> perturbation_sim;
+    double target_error =
+        dps_plot_target_error > 0 ? dps_plot_target_error : sim->target_error;
+
+    if ( dps_plot_perturbation && target_error <= 0 && !dps_plot_debug &&
+         sim->can_perturb( i ) && start != end )
+    {
+      perturbation_sim = std::unique_ptr<sim_t>( new sim_t( sim ) );
+      if ( dps_plot_iterations > 0 )
+      {
+        perturbation_sim->work_queue->init( dps_plot_iterations );
+      }
+      for ( int j = start; j <= end; j++ )
+      {
+        if ( j == 0 )
+          continue;
+
+        stat_perturbation_t point;
+        point.stats.push_back( std::make_pair( i, j * dps_plot_step ) );
+        if ( sim->report_progress )
+          point.phase_str = plot_phase_str( i, j * dps_plot_step );
+        perturbation_sim->perturbations.push_back( point );
+      }
+
+      // Points furthest from the base stats are the most likely to differ
+      // from a sim of their own
+      stat_perturbation_t extreme;
+      extreme.stats.push_back( std::make_pair(
+          i, ( std::abs( start ) > std::abs( end ) ? start : end ) *
+                 dps_plot_step ) );
+      if ( perturbation_sim->verify_perturbation( extreme ) )
+      {
+        perturbation_sim->execute();
+      }
+      else
+      {
+        sim->errorf(
+            "An actor derives values from %s during init, plotting it with a "
+            "sim per point.\n",
+            util::stat_type_string( i ) );
+        perturbation_sim.reset();
+      }
+    }
+
+    size_t point = 0;
+
     for ( int j = start; j <= end; j++ )
     {
       if ( sim->is_canceled() )
@@ -167,7 +226,7 @@ void plot_t::analyze_stats()
 
       std::unique_ptr<sim_t> delta_sim;
 
-      if ( j != 0 )
+      if ( j != 0 && !perturbation_sim )
       {
         delta_sim = std::unique_ptr<sim_t>( new sim_t( sim ) );
         if ( dps_plot_iterations > 0 )
@@ -178,14 +237,7 @@ void plot_t::analyze_stats()
           delta_sim->target_error = dps_plot_target_error;
         delta_sim->enchant.add_stat( i, j * dps_plot_step );
         if ( sim->report_progress )
-        {
-          std::stringstream stat_name;
-          stat_name.width( 12 );
-          stat_name << std::left
-                    << std::string( util::stat_type_abbrev( i ) ) + ":";
-          delta_sim->sim_phase_str =
-              util::to_string( j * dps_plot_step ) + " " + stat_name.str();
-        }
+          delta_sim->sim_phase_str = plot_phase_str( i, j * dps_plot_step );
         delta_sim->execute();
         if ( dps_plot_debug )
         {
@@ -212,6 +264,15 @@ void plot_t::analyze_stats()
           data.value = scaling_data.value;
           data.error = scaling_data.stddev * delta_sim->confidence_estimator;
         }
+        else if ( perturbation_sim && j != 0 )
+        {
+          scaling_metric_data_t scaling_data =
+              perturbation_sim->perturbation_result( point, *p );
+
+          data.value = scaling_data.value;
+          data.error =
+              scaling_data.stddev * perturbation_sim->confidence_estimator;
+        }
         else
         {
           scaling_metric_data_t scaling_data =
@@ -223,8 +284,9 @@ void plot_t::analyze_stats()
         p->dps_plot_data[ i ].push_back( data );
       }
 
-      if ( delta_sim )
+      if ( j != 0 )
       {
+        point++;
         remaining_plot_points--;
       }
     }
@@ -284,6 +346,7 @@ void plot_t::create_options()
   sim->add_option( opt_string( "dps_plot_stat", dps_plot_stat_str ) );
   sim->add_option( opt_float( "dps_plot_step", dps_plot_step ) );
   sim->add_option( opt_bool( "dps_plot_debug", dps_plot_debug ) );
+  sim->add_option( opt_bool( "dps_plot_perturbation", dps_plot_perturbation ) );
   sim->add_option( opt_bool( "dps_plot_positive", dps_plot_positive ) );
   sim->add_option( opt_bool( "dps_plot_negative", dps_plot_negative ) );
 }
@@ -37,6 +37,59 @@ bool is_plot_stat( sim_t* sim, stat_e stat )
   return it != sim->player_no_pet_list.end();
 }
 
+/// Progress bar label of a point
+std::string reforge_phase_str( const reforge_plot_run_t& plot,
+                               const std::vector<int>& mods )
+{
+  std::string str;
+  for ( size_t j = 0; j < mods.size(); j++ )
+  {
+    str += util::to_string( mods[ j ] ) + " " +
+           util::stat_type_abbrev( plot.reforge_plot_stat_indices[ j ] );
+
+    if ( j < mods.size() - 1 )
+      str += ",";
+  }
+
+  str += ":";
+  if ( str.length() < 23 )
+    str.append( 23 - str.length(), ' ' );
+
+  return str;
+}
+
+/// Plot rows of a point per player in players_by_name order: the stat mods,
+/// followed by the scaling metric of the player
+template <typename Metric>
+std::vector<std::vector<plot_data_t>> reforge_rows( sim_t* sim,
+                                                    const std::vector<int>& mods,
+                                                    Metric metric,
+                                                    double confidence_estimator )
+{
+  std::vector<std::vector<plot_data_t>> rows;
+  std::vector<plot_data_t> delta_result( mods.size() + 1 );
+
+  for ( size_t j = 0; j < mods.size(); j++ )
+  {
+    delta_result[ j ].value = mods[ j ];
+    delta_result[ j ].error = 0;
+  }
+
+  for ( player_t* player : sim->players_by_name )
+  {
+    plot_data_t& data = delta_result[ mods.size() ];
+
+    scaling_metric_data_t scaling_data = metric( player );
+
+    data.value = scaling_data.value;
+    data.error = scaling_data.stddev * confidence_estimator;
+
+    rows.push_back( delta_result );
+  }
+
+  return rows;
+}
+
 /**
  * Parse user option string into a 2 dimensional vector[plot#][stat]
  */
@@ -65,6 +118,103 @@ std::vector<reforge_plot_run_t> build_reforge_plot_stats(
   return result;
 }
 
+/**
+ * Quadratic least squares fit of the scaling metric over the free stat
+ * coordinates of a reforge plot. The adaptive search uses it to guess which
+ * unsampled points could still beat the best one.
+ */
+struct quadratic_surrogate_t
+{
+  size_t dims;
+  std::vector<double> coefficients;
+  double rms;
+
+  quadratic_surrogate_t( size_t d ) : dims( d ), rms( 0 )
+  {
+  }
+
+  size_t size() const
+  {
+    return 1 + dims + dims * ( dims + 1 ) / 2;
+  }
+
+  std::vector<double> features( const std::vector<double>& x ) const
+  {
+    std::vector<double> f( 1, 1.0 );
+    for ( size_t i = 0; i < dims; i++ )
+      f.push_back( x[ i ] );
+    for ( size_t i = 0; i < dims; i++ )
+      for ( size_t j = i; j < dims; j++ )
+        f.push_back( x[ i ] * x[ j ] );
+    return f;
+  }
+
+  double predict( const std::vector<double>& x ) const
+  {
+    std::vector<double> f = features( x );
+    double v = 0;
+    for ( size_t i = 0; i < f.size(); i++ )
+      v += coefficients[ i ] * f[ i ];
+    return v;
+  }
+
+  /// Fit through the normal equations; false if the points do not determine
+  /// the surface
+  bool fit( const std::vector<std::vector<double>>& x,
+            const std::vector<double>& y )
+  {
+    size_t n = size();
+    if ( x.size() <= n )
+      return false;
+
+    std::vector<std::vector<double>> a( n, std::vector<double>( n + 1 ) );
+    for ( size_t k = 0; k < x.size(); k++ )
+    {
+      std::vector<double> f = features( x[ k ] );
+      for ( size_t i = 0; i < n; i++ )
+      {
+        for ( size_t j = 0; j < n; j++ )
+          a[ i ][ j ] += f[ i ] * f[ j ];
+        a[ i ][ n ] += f[ i ] * y[ k ];
+      }
+    }
+
+    for ( size_t c = 0; c < n; c++ )
+    {
+      size_t pivot = c;
+      for ( size_t r = c + 1; r < n; r++ )
+        if ( std::fabs( a[ r ][ c ] ) > std::fabs( a[ pivot ][ c ] ) )
+          pivot = r;
+      if ( std::fabs( a[ pivot ][ c ] ) < 1e-9 )
+        return false;
+      std::swap( a[ c ], a[ pivot ] );
+
+      for ( size_t r = 0; r < n; r++ )
+      {
+        if ( r == c )
+          continue;
+        double m = a[ r ][ c ] / a[ c ][ c ];
+        for ( size_t k = c; k <= n; k++ )
+          a[ r ][ k ] -= m * a[ c ][ k ];
+      }
+    }
+
+    coefficients.resize( n );
+    for ( size_t i = 0; i < n; i++ )
+      coefficients[ i ] = a[ i ][ n ] / a[ i ][ i ];
+
+    double sq = 0;
+    for ( size_t k = 0; k < x.size(); k++ )
+    {
+      double d = predict( x[ k ] ) - y[ k ];
+      sq += d * d;
+    }
+    rms = std::sqrt( sq / x.size() );
+
+    return true;
+  }
+};
+
 }  // UNNAMED NAMESPACE ====================================================
 
 // ==========================================================================
@@ -81,6 +231,8 @@ reforge_plot_t::reforge_plot_t( sim_t* s )
     reforge_plot_iterations( -1 ),
     reforge_plot_target_error( 0 ),
     reforge_plot_debug( 0 ),
+    reforge_plot_adaptive( 0 ),
+    reforge_plot_perturbation( 0 ),
     current_stat_combo( 0 ),
     num_stat_combos( 0 )
 {
@@ -171,87 +323,325 @@ void reforge_plot_t::debug_plot(
   }
 }
 
-void reforge_plot_t::run_reforge_plot( const reforge_plot_run_t& plot )
+/// Run one sim with the given stat mods, returning the plot row of each player
+/// in players_by_name order
+std::vector<std::vector<plot_data_t>> reforge_plot_t::run_reforge_point(
+    const reforge_plot_run_t& plot,
+    const std::vector<int>& mods )
 {
-  // Create vector of all stat_add combinations recursively
-  std::vector<int> cur_stat_mods( plot.reforge_plot_stat_indices.size() );
-  std::vector<std::vector<int>> stat_mods;
-  generate_stat_mods( stat_mods, plot.reforge_plot_stat_indices, 0,
-                      cur_stat_mods );
+  current_reforge_sim = new sim_t( sim );
+  if ( reforge_plot_iterations > 0 )
+  {
+    current_reforge_sim->work_queue->init( reforge_plot_iterations );
+  }
 
-  num_stat_combos = as<int>( stat_mods.size() );
+  for ( size_t j = 0; j < mods.size(); j++ )
+    current_reforge_sim->enchant.add_stat( plot.reforge_plot_stat_indices[ j ],
+                                           mods[ j ] );
 
-  debug_plot( plot, stat_mods );
+  if ( sim->report_progress )
+    current_reforge_sim->sim_phase_str += reforge_phase_str( plot, mods );
 
-  for ( player_t* player : sim->players_by_name )
-  {
-    player->reforge_plot_data[&plot];
-  }
+  current_reforge_sim->execute();
 
-  for ( size_t i = 0; i < stat_mods.size(); i++ )
-  {
-    if ( sim->is_canceled() )
-      break;
+  std::vector<std::vector<plot_data_t>> rows =
+      reforge_rows( sim, mods, [this]( player_t* player ) -> scaling_metric_data_t {
+        player_t* delta_p = current_reforge_sim->find_player( player->name() );
+        return delta_p->scaling_for_metric( sim->scaling->scaling_metric );
+      }, current_reforge_sim->confidence_estimator );
+
+  delete current_reforge_sim;
+  current_reforge_sim = nullptr;
+
+  return rows;
+}
+
+/// Run the points with the given stat mods, returning the plot rows of each
+/// point per player in players_by_name order. When asked to, and without a
+/// target error, every point runs the same number of iterations, so all of
+/// them share one sim that has its players' stats perturbed in place.
+std::vector<std::vector<std::vector<plot_data_t>>>
+reforge_plot_t::run_reforge_points( const reforge_plot_run_t& plot,
+                                    const std::vector<std::vector<int>>& mods )
+{
+  std::vector<std::vector<std::vector<plot_data_t>>> results;
 
-    std::vector<plot_data_t> delta_result( stat_mods[ i ].size() + 1 );
+  bool perturb = reforge_plot_perturbation && sim->target_error <= 0;
+  for ( stat_e stat : plot.reforge_plot_stat_indices )
+    perturb = perturb && sim->can_perturb( stat );
 
+  if ( perturb )
+  {
     current_reforge_sim = new sim_t( sim );
     if ( reforge_plot_iterations > 0 )
     {
       current_reforge_sim->work_queue->init( reforge_plot_iterations );
     }
 
-    std::string& tmp = current_reforge_sim->sim_phase_str;
-    for ( size_t j = 0; j < stat_mods[ i ].size(); j++ )
+    for ( const auto& point_mods : mods )
     {
-      stat_e stat = plot.reforge_plot_stat_indices[ j ];
-      int mod     = stat_mods[ i ][ j ];
-      current_reforge_sim->enchant.add_stat( stat, mod );
-      delta_result[ j ].value = mod;
-      delta_result[ j ].error = 0;
-
+      stat_perturbation_t point;
+      for ( size_t j = 0; j < point_mods.size(); j++ )
+        point.stats.push_back( std::make_pair(
+            plot.reforge_plot_stat_indices[ j ], double( point_mods[ j ] ) ) );
       if ( sim->report_progress )
-      {
-        tmp += util::to_string( mod ) + " " + util::stat_type_abbrev( stat );
+        point.phase_str = reforge_phase_str( plot, point_mods );
+      current_reforge_sim->perturbations.push_back( point );
+    }
 
-        if ( j < stat_mods[ i ].size() - 1 )
-          tmp += ",";
-      }
+    // Every stat at the full reforge amount is as far from the base stats as
+    // any point gets
+    stat_perturbation_t extreme;
+    for ( stat_e stat : plot.reforge_plot_stat_indices )
+      extreme.stats.push_back(
+          std::make_pair( stat, double( reforge_plot_amount ) ) );
+
+    if ( !current_reforge_sim->verify_perturbation( extreme ) )
+    {
+      sim->errorf(
+          "An actor derives values from the reforge plot stats during init, "
+          "plotting them with a sim per point.\n" );
+      delete current_reforge_sim;
+      current_reforge_sim = nullptr;
+      perturb = false;
     }
+  }
 
-    if ( sim->report_progress )
+  if ( !perturb )
+  {
+    for ( const auto& point_mods : mods )
     {
-      tmp += ":";
-      if ( tmp.length() < 23 )
-        tmp.append( 23 - tmp.length(), ' ' );
+      if ( sim->is_canceled() )
+        break;
+      results.push_back( run_reforge_point( plot, point_mods ) );
+      current_stat_combo++;
     }
+    return results;
+  }
+
+  current_reforge_sim->execute();
 
-    current_stat_combo = as<int>( i );
-    current_reforge_sim->execute();
+  for ( size_t i = 0; i < mods.size(); i++ )
+  {
+    results.push_back( reforge_rows( sim, mods[ i ], [&]( player_t* player ) -> scaling_metric_data_t {
+      return current_reforge_sim->perturbation_result( i, *player );
+    }, current_reforge_sim->confidence_estimator ) );
+  }
+  current_stat_combo += as<int>( mods.size() );
+
+  delete current_reforge_sim;
+  current_reforge_sim = nullptr;
 
-    for ( player_t* player : sim->players_by_name )
+  return results;
+}
+
+/**
+ * Sample the plot grid coarse to fine. Each level halves the spacing, and of
+ * the new points only those are run that the surrogate of some player places
+ * within the confidence interval of that player's best point, or that lie
+ * where the sampled surface changes faster than average. The search stops
+ * once no unsampled point of a level can reach the confidence interval of
+ * the best point for any player, ie. the optimum is resolved; points picked
+ * for the shape of the surface alone do not keep it going.
+ */
+void reforge_plot_t::run_adaptive_reforge_plot(
+    const reforge_plot_run_t& plot,
+    const std::vector<std::vector<int>>& stat_mods,
+    std::vector<std::vector<std::vector<plot_data_t>>>& results )
+{
+  size_t dims   = plot.reforge_plot_stat_indices.size() - 1;
+  int center    = reforge_plot_amount / reforge_plot_step;
+  // Positions are scaled to [-1, 1] for the surrogate. An amount smaller
+  // than the step leaves center at 0, so scale by at least one step.
+  double scale  = std::max( 1, center );
+  size_t n_players = sim->players_by_name.size();
+
+  // Grid position of every point along the free stats, relative to the point
+  // reforge_plot_amount / reforge_plot_step steps in. That is no reforge
+  // when the amount is a multiple of the step, and the grid point next to it
+  // otherwise.
+  std::vector<std::vector<int>> pos( stat_mods.size(), std::vector<int>( dims ) );
+  for ( size_t i = 0; i < stat_mods.size(); i++ )
+    for ( size_t j = 0; j < dims; j++ )
+      pos[ i ][ j ] = ( stat_mods[ i ][ j ] + reforge_plot_amount ) / reforge_plot_step - center;
+
+  auto aligned = [&pos, dims]( size_t i, int spacing ) {
+    for ( size_t j = 0; j < dims; j++ )
+      if ( pos[ i ][ j ] % spacing != 0 )
+        return false;
+    return true;
+  };
+
+  auto run = [&]( const std::vector<size_t>& points ) {
+    std::vector<std::vector<int>> mods;
+    for ( size_t i : points )
+      mods.push_back( stat_mods[ i ] );
+
+    auto rows = run_reforge_points( plot, mods );
+    for ( size_t k = 0; k < rows.size(); k++ )
+      results[ points[ k ] ] = rows[ k ];
+  };
+
+  // Coarsest level has at least five points along each free stat
+  int spacing = 1;
+  while ( spacing * 4 <= center )
+    spacing *= 2;
+
+  std::vector<size_t> points;
+  for ( size_t i = 0; i < stat_mods.size(); i++ )
+    if ( aligned( i, spacing ) )
+      points.push_back( i );
+  run( points );
+
+  while ( spacing > 1 && !sim->is_canceled() )
+  {
+    int previous = spacing;
+    spacing /= 2;
+
+    std::vector<size_t> sampled, candidates;
+    for ( size_t i = 0; i < stat_mods.size(); i++ )
     {
-      if ( current_reforge_sim )
+      if ( !results[ i ].empty() )
+        sampled.push_back( i );
+      else if ( aligned( i, spacing ) )
+        candidates.push_back( i );
+    }
+
+    std::vector<bool> selected( candidates.size() );
+    bool near_optimum = false;
+
+    for ( size_t p = 0; p < n_players; p++ )
+    {
+      std::vector<std::vector<double>> x;
+      std::vector<double> y;
+      double best = -std::numeric_limits<double>::max(), best_error = 0;
+      for ( size_t i : sampled )
       {
-        plot_data_t& data = delta_result[ stat_mods[ i ].size() ];
-        player_t* delta_p = current_reforge_sim->find_player( player->name() );
+        const plot_data_t& d = results[ i ][ p ].back();
+        std::vector<double> xi( dims );
+        for ( size_t j = 0; j < dims; j++ )
+          xi[ j ] = pos[ i ][ j ] / scale;
+        x.push_back( xi );
+        y.push_back( d.value );
+        if ( d.value > best )
+        {
+          best       = d.value;
+          best_error = d.error;
+        }
+      }
 
-        scaling_metric_data_t scaling_data =
-            delta_p->scaling_for_metric( player->sim->scaling->scaling_metric );
+      quadratic_surrogate_t surrogate( dims );
+      bool fitted = surrogate.fit( x, y );
 
-        data.value = scaling_data.value;
-        data.error =
-            scaling_data.stddev * current_reforge_sim->confidence_estimator;
+      // Spread of the sampled values around each candidate
+      std::vector<double> spread( candidates.size() );
+      double mean_spread = 0;
+      for ( size_t c = 0; c < candidates.size(); c++ )
+      {
+        double lo = std::numeric_limits<double>::max(), hi = -lo, error = 0;
+        for ( size_t s = 0; s < sampled.size(); s++ )
+        {
+          bool near = true;
+          for ( size_t j = 0; j < dims && near; j++ )
+            near = std::abs( pos[ sampled[ s ] ][ j ] - pos[ candidates[ c ] ][ j ] ) <= previous;
+          if ( !near )
+            continue;
+          lo    = std::min( lo, y[ s ] );
+          hi    = std::max( hi, y[ s ] );
+          error = std::max( error, results[ sampled[ s ] ][ p ].back().error );
+        }
+        spread[ c ] = hi > lo ? hi - lo : 0;
+        // Changes within the noise of the sims do not count
+        if ( spread[ c ] <= 2 * error )
+          spread[ c ] = 0;
+        mean_spread += spread[ c ];
+      }
+      if ( !candidates.empty() )
+        mean_spread /= candidates.size();
+
+      for ( size_t c = 0; c < candidates.size(); c++ )
+      {
+        if ( spread[ c ] > 0 && spread[ c ] >= mean_spread )
+          selected[ c ] = true;
 
-        auto& pd = player->reforge_plot_data[&plot];
-        pd.push_back(delta_result);
+        if ( !fitted )
+        {
+          selected[ c ] = near_optimum = true;
+          continue;
+        }
+
+        std::vector<double> xc( dims );
+        for ( size_t j = 0; j < dims; j++ )
+          xc[ j ] = pos[ candidates[ c ] ][ j ] / scale;
+        if ( surrogate.predict( xc ) >= best - best_error - surrogate.rms )
+          selected[ c ] = near_optimum = true;
       }
     }
 
-    if ( current_reforge_sim )
+    if ( !near_optimum )
     {
-      delete current_reforge_sim;
-      current_reforge_sim = nullptr;
+      if ( reforge_plot_debug )
+        sim->out_log.raw().printf( "Reforge Plot optimum resolved at step %d\n",
+                                   previous * reforge_plot_step );
+      break;
+    }
+
+    points.clear();
+    for ( size_t c = 0; c < candidates.size(); c++ )
+      if ( selected[ c ] )
+        points.push_back( candidates[ c ] );
+
+    if ( reforge_plot_debug )
+      sim->out_log.raw().printf( "Reforge Plot refining at step %d: %d of %d points\n",
+                                 spacing * reforge_plot_step, as<int>( points.size() ),
+                                 as<int>( candidates.size() ) );
+
+    if ( points.empty() )
+      break;
+
+    run( points );
+  }
+}
+
+void reforge_plot_t::run_reforge_plot( const reforge_plot_run_t& plot )
+{
+  // Create vector of all stat_add combinations recursively
+  std::vector<int> cur_stat_mods( plot.reforge_plot_stat_indices.size() );
+  std::vector<std::vector<int>> stat_mods;
+  generate_stat_mods( stat_mods, plot.reforge_plot_stat_indices, 0,
+                      cur_stat_mods );
+
+  num_stat_combos = as<int>( stat_mods.size() );
+  current_stat_combo = 0;
+
+  debug_plot( plot, stat_mods );
+
+  for ( player_t* player : sim->players_by_name )
+  {
+    player->reforge_plot_data[&plot];
+  }
+
+  // Rows of each grid point, per player; points that were not run stay empty
+  std::vector<std::vector<std::vector<plot_data_t>>> results( stat_mods.size() );
+
+  if ( reforge_plot_adaptive && plot.reforge_plot_stat_indices.size() > 1 )
+  {
+    run_adaptive_reforge_plot( plot, stat_mods, results );
+    // The skipped points are done as well
+    num_stat_combos = current_stat_combo;
+  }
+  else
+  {
+    auto rows = run_reforge_points( plot, stat_mods );
+    for ( size_t i = 0; i < rows.size(); i++ )
+      results[ i ] = rows[ i ];
+  }
+
+  for ( const auto& rows : results )
+  {
+    for ( size_t p = 0; p < rows.size(); p++ )
+    {
+      sim->players_by_name[ p ]->reforge_plot_data[&plot].push_back( rows[ p ] );
     }
   }
 }
@@ -322,6 +712,13 @@ void reforge_plot_t::start()
   if ( reforge_plot_stat_str.empty() )
     return;
 
+  if ( reforge_plot_step <= 0 )
+  {
+    sim->errorf( "Reforge plot step must be greater than zero, got %d.\n",
+                 reforge_plot_step );
+    return;
+  }
+
   run_plots();
 
   write_output_file();
@@ -358,6 +755,12 @@ double reforge_plot_t::progress( std::string& phase, std::string* detailed )
                                                 ? reforge_plot_iterations
                                                 : sim->iterations );
 
+  // Points already run by the current perturbation sim
+  if ( current_reforge_sim )
+    reforge_iter += as<int>( current_reforge_sim->current_perturbation ) *
+                    ( reforge_plot_iterations > 0 ? reforge_plot_iterations
+                                                  : sim->iterations );
+
   if ( current_reforge_sim && current_reforge_sim->current_iteration > 0 )
   {
     // Add current reforge iterations only if the update does not land on a
@@ -391,4 +794,7 @@ void reforge_plot_t::create_options()
   sim->add_option( opt_int( "reforge_plot_amount", reforge_plot_amount ) );
   sim->add_option( opt_string( "reforge_plot_stat", reforge_plot_stat_str ) );
   sim->add_option( opt_bool( "reforge_plot_debug", reforge_plot_debug ) );
+  sim->add_option( opt_bool( "reforge_plot_adaptive", reforge_plot_adaptive ) );
+  sim->add_option(
+      opt_bool( "reforge_plot_perturbation", reforge_plot_perturbation ) );
 }
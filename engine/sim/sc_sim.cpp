@@ -843,6 +843,16 @@ bool parse_maximize_reporting( sim_t*             sim,
   return true;
 }
 
+/// Seed used when none was given
+uint64_t choose_seed( bool deterministic )
+{
+  if ( deterministic )
+    return 31459;
+
+  std::random_device rd;
+  return uint64_t(rd()) | (uint64_t(rd()) << 32);
+}
+
 /**
  * Parse threads option, and if equal or lower than 0, adjust
  * the number of threads to the number of cpu cores minus the absolute value given as a thread option.
@@ -953,39 +963,6 @@ struct sim_safeguard_end_event_t : public sim_end_event_t
   }
 };
 
-struct resource_timeline_collect_event_t : public event_t
-{
-  resource_timeline_collect_event_t( sim_t& s ) :
-    event_t( s )
-  {
-    add_event( timespan_t::from_seconds( 1 ) );
-  }
-  virtual const char* name() const override
-  { return "resource_timeline_collect_event_t"; }
-  virtual void execute() override
-  {
-    if ( sim().iterations == 1 || sim().current_iteration > 0 )
-    {
-      // Assumptions: Enemies do not have primary resource regeneration
-      for ( size_t i = 0, actors = sim().player_non_sleeping_list.size(); i < actors; i++ )
-      {
-        player_t* p = sim().player_non_sleeping_list[ i ];
-        if ( p -> primary_resource() == RESOURCE_NONE ) continue;
-
-        p -> collect_resource_timeline_information();
-      }
-      // However, enemies do have health
-      for ( size_t i = 0, actors = sim().target_non_sleeping_list.size(); i < actors; i++ )
-      {
-        player_t* p = sim().target_non_sleeping_list[ i ];
-        p -> collect_resource_timeline_information();
-      }
-    }
-
-    new ( sim() ) resource_timeline_collect_event_t( sim() );
-  }
-};
-
 struct regen_event_t : public event_t
 {
   regen_event_t( sim_t& s ) :
@@ -1215,6 +1192,53 @@ struct compare_name
   }
 };
 
+// Sample data the scaling metric of an actor is taken from, see
+// player_t::scaling_for_metric(); healing per second gets absorbs as second
+// sample data
+const extended_sample_data_t* scaling_metric_samples( const player_t& p, scale_metric_e metric,
+                                                      const extended_sample_data_t*& second )
+{
+  second = nullptr;
+  const player_collected_data_t& cd = p.collected_data;
+
+  switch ( metric )
+  {
+    case SCALE_METRIC_DPS:       return &cd.dps;
+    case SCALE_METRIC_DPSE:      return &cd.dpse;
+    case SCALE_METRIC_HPS:       return &cd.hps;
+    case SCALE_METRIC_HPSE:      return &cd.hpse;
+    case SCALE_METRIC_APS:       return &cd.aps;
+    case SCALE_METRIC_DPSP:      return &cd.prioritydps;
+    case SCALE_METRIC_HAPS:      second = &cd.aps; return &cd.hps;
+    case SCALE_METRIC_DTPS:      return &cd.dtps;
+    case SCALE_METRIC_DMG_TAKEN: return &cd.dmg_taken;
+    case SCALE_METRIC_HTPS:      return &cd.htps;
+    case SCALE_METRIC_TMI:       return &cd.theck_meloree_index;
+    case SCALE_METRIC_ETMI:      return &cd.effective_theck_meloree_index;
+    case SCALE_METRIC_DEATHS:    return &cd.deaths;
+    default:
+      if ( p.primary_role() == ROLE_TANK )
+        return &cd.dtps;
+      else if ( p.primary_role() == ROLE_HEAL )
+        return scaling_metric_samples( p, SCALE_METRIC_HAPS, second );
+      else
+        return &cd.dps;
+  }
+}
+
+// Sum of the samples of d after the first count ones, or of all of them when
+// the sample data only keeps a running sum
+double sample_tail_sum( const extended_sample_data_t& d, size_t count )
+{
+  if ( d.simple )
+    return d.sum();
+
+  double sum = 0;
+  for ( size_t i = count, end = d.data().size(); i < end; ++i )
+    sum += d.data()[ i ];
+  return sum;
+}
+
 } // UNNAMED NAMESPACE ===================================================
 
 // ==========================================================================
@@ -1229,6 +1253,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   out_log( *this, &std::cout, sim_ostream_t::no_close() ),
   out_debug(*this, &std::cout, sim_ostream_t::no_close() ),
   debug( false ),
+  event_trace( *this ),
   max_time( timespan_t::zero() ),
   expected_iteration_time( timespan_t::zero() ),
   vary_combat_length( 0.0 ),
@@ -1263,7 +1288,9 @@ sim_t::sim_t( sim_t* p, int index ) :
   travel_variance( 0 ), default_skill( 1.0 ), reaction_time( timespan_t::from_seconds( 0.5 ) ),
   regen_periodicity( timespan_t::from_seconds( 0.25 ) ),
   ignite_sampling_delta( timespan_t::from_seconds( 0.2 ) ),
-  fixed_time( false ), optimize_expressions( false ),
+  fixed_time( false ), optimize_expressions( false ), verify_folded_multipliers( false ),
+  action_sequence_samples( false ),
+  cooldown_recharge_events( false ),
   current_slot( -1 ),
   optimal_raid( 0 ), log( 0 ), debug_each( 0 ), save_profiles( 0 ), default_actions( 0 ),
   normalized_stat( STAT_NONE ),
@@ -1271,8 +1298,9 @@ sim_t::sim_t( sim_t* p, int index ) :
   save_prefix_str( "save_" ),
   save_talent_str( 0 ),
   talent_format( TALENT_FORMAT_UNCHANGED ),
-  auto_ready_trigger( 0 ), stat_cache( 1 ), max_aoe_enemies( 20 ), show_etmi( 0 ), tmi_window_global( 0 ), tmi_bin_size( 0.5 ),
-  requires_regen_event( false ), enemy_death_pct( 0 ), rel_target_level( -1 ), target_level( -1 ), target_adds( 0 ), desired_targets( 0 ), enable_taunts( false ),
+  auto_ready_trigger( 0 ), stat_cache( 1 ), max_aoe_enemies( 20 ), show_etmi( 0 ), tmi_window_global( 0 ), tmi_bin_size( 0.5 ), timeline_resolution( 1.0 ),
+  health_calibration_iterations( 0 ), calibrating_health( false ),
+  requires_regen_event( false ), static_regen( false ), collect_timelines( false ), enemy_death_pct( 0 ), rel_target_level( -1 ), target_level( -1 ), target_adds( 0 ), desired_targets( 0 ), enable_taunts( false ),
   challenge_mode( false ), timewalk( -1 ), scale_to_itemlevel( -1 ), scale_itemlevel_down_only( false ),
   disable_set_bonuses( false ), disable_2_set( 1 ), disable_4_set( 1 ), enable_2_set( 1 ), enable_4_set( 1 ),
   pvp_crit( false ),
@@ -1289,6 +1317,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   reforge_plot( new reforge_plot_t( this ) ),
   elapsed_cpu( 0.0 ),
   elapsed_time( 0.0 ),
+  init_profile(),
   iteration_dmg( 0 ), priority_iteration_dmg( 0 ), iteration_heal( 0 ), iteration_absorb( 0 ),
   raid_dps(), total_dmg(), raid_hps(), total_heal(), total_absorb(), raid_aps(),
   simulation_length( "Simulation Length", false ),
@@ -1313,9 +1342,10 @@ sim_t::sim_t( sim_t* p, int index ) :
   scaling_normalized( 1.0 ),
   report_information(),
   // Multi-Threading
-  threads( 0 ), thread_index( index ), process_priority( computer_process::BELOW_NORMAL ),
+  threads( 0 ), import_threads( 4 ), thread_index( index ), process_priority( computer_process::BELOW_NORMAL ),
   work_queue( new work_queue_t() ),
-  spell_query(), spell_query_level( MAX_LEVEL ),
+  current_perturbation( 0 ),
+  spell_query(), spell_query_level( MAX_LEVEL ), spell_query_index( true ),
   pause_mutex( nullptr ),
   paused( false ),
   // Highcharts stuff
@@ -1350,10 +1380,18 @@ sim_t::sim_t( sim_t* p, int index ) :
 
     // Inherit 'plot' settings from parent because are set outside of the config file
     enchant = parent -> enchant;
+    perturbations = parent -> perturbations;
 
     // While we inherit the parent seed, it may get overwritten in sim_t::init
     seed = parent -> seed;
 
+    // Start from the enemy health calibrated by the parent
+    calibrated_health = parent -> calibrated_health;
+
+    // Worker threads add their iterations to the parent's trace
+    if ( thread_index > 0 )
+      event_trace.writer = parent -> event_trace.writer;
+
     parent -> add_relative( this );
   }
 }
@@ -1553,6 +1591,8 @@ void sim_t::combat_begin()
 
   reset();
 
+  event_trace.iteration_begin();
+
   iteration_dmg = priority_iteration_dmg = iteration_heal = 0;
 
   // Always call begin() to ensure various counters are initialized.
@@ -1652,7 +1692,7 @@ void sim_t::combat_end()
     b -> expire();
   }
 
-  if ( iterations == 1 || current_iteration >= 1 )
+  if ( ! calibrating_health && ( iterations == 1 || current_iteration >= 1 ) )
     datacollection_end();
 
   assert( active_enemies == 0 );
@@ -1662,7 +1702,10 @@ void sim_t::combat_end()
 
   event_mgr.flush();
 
-  analyze_error();
+  if ( ! calibrating_health )
+    analyze_error();
+
+  event_trace.iteration_end();
 
   if ( debug_each && ! canceled )
     static_cast<io::ofstream*>(out_std.get_stream()) -> close();
@@ -1692,7 +1735,9 @@ void sim_t::datacollection_begin()
     p -> datacollection_begin();
   }
 
-  new ( *this ) resource_timeline_collect_event_t( *this );
+  // Timelines are sampled by the actors themselves from when they arise; see
+  // player_t::sample_timelines()
+  collect_timelines = ! calibrating_health && ( iterations == 1 || current_iteration > 0 );
 }
 
 // sim_t::datacollection_end ================================================
@@ -1703,6 +1748,13 @@ void sim_t::datacollection_end()
 
   simulation_length.add( current_time().total_seconds() );
 
+  // Take the timeline samples still owed by actors active at the end
+  for ( size_t i = 0, end = player_non_sleeping_list.size(); i < end; ++i )
+    player_non_sleeping_list[ i ] -> sample_timelines();
+  for ( size_t i = 0, end = target_non_sleeping_list.size(); i < end; ++i )
+    target_non_sleeping_list[ i ] -> sample_timelines();
+  collect_timelines = false;
+
   for ( size_t i = 0; i < target_list.size(); ++i )
   {
     player_t* t = target_list[ i ];
@@ -1729,6 +1781,9 @@ void sim_t::datacollection_end()
   total_absorb.add( iteration_absorb );
   raid_aps.add( current_time() != timespan_t::zero() ? iteration_absorb / current_time().total_seconds() : 0 );
 
+  if ( ! perturbations.empty() )
+    sample_perturbation();
+
   if ( deterministic && report_iteration_data > 0 && current_iteration > 0 && current_time() > timespan_t::zero() )
   {
     // TODO: Metric should be selectable
@@ -1939,6 +1994,8 @@ bool sim_t::init_actors()
   if ( decorated_tooltips == -1 )
     decorated_tooltips = 1;
 
+  // Actors are initialized one at a time: init_actor writes shared sim state
+  // (active player, current slot and name, sim cooldowns, error list, rng).
   actor_init = true;
   for ( size_t i = 0; i < player_no_pet_list.size(); ++i )
   {
@@ -1978,6 +2035,7 @@ bool sim_t::init_actors()
 bool sim_t::init_actor( player_t* p )
 {
   bool ret = true;
+  double t = util::wall_time();
 
   // initialize class/enemy modules
   for ( player_e i = PLAYER_NONE; i < PLAYER_MAX; ++i )
@@ -1985,6 +2043,7 @@ bool sim_t::init_actor( player_t* p )
     const module_t* m = module_t::get( i );
     if ( m ) m -> init( p );
   }
+  t = init_profile.add( "actor_modules", t );
 
   if ( default_actions && ! p -> is_pet() )
   {
@@ -2003,12 +2062,14 @@ bool sim_t::init_actor( player_t* p )
 
   p -> init_target();
   p -> init_character_properties();
+  t = init_profile.add( "actor_base", t );
 
   // Initialize each actor's items, construct gear information & stats
   if ( ! p -> init_items() )
   {
     ret = false;
   }
+  t = init_profile.add( "actor_items", t );
 
   p -> init_spells();
   p -> init_base_stats();
@@ -2016,15 +2077,18 @@ bool sim_t::init_actor( player_t* p )
   p -> init_defense();
   p -> create_buffs();
   p -> init_scaling();
+  t = init_profile.add( "actor_stats", t );
 
   // Procs must be initialized before actions
   p -> init_special_effects();
   p -> register_callbacks();
+  t = init_profile.add( "actor_special_effects", t );
 
   if ( ! p -> init_actions() )
   {
     ret = false;
   }
+  t = init_profile.add( "actor_actions", t );
 
   p -> init_gains();
   p -> init_procs();
@@ -2034,10 +2098,27 @@ bool sim_t::init_actor( player_t* p )
   p -> init_stats();
   p -> init_distance_targeting();
   p -> init_absorb_priority();
+  p -> init_absorb_sequence();
+  init_profile.add( "actor_finish", t );
 
   return ret;
 }
 
+// sim_t::init_profile_t::add ===============================================
+
+double sim_t::init_profile_t::add( const std::string& name, double start )
+{
+  double now = util::wall_time();
+
+  auto it = range::find_if( phases, [ &name ]( const std::pair<std::string, double>& p ) { return p.first == name; } );
+  if ( it == phases.end() )
+    phases.push_back( std::make_pair( name, now - start ) );
+  else
+    it -> second += now - start;
+
+  return now;
+}
+
 // sim_t::init_actor_pets ===================================================
 
 bool sim_t::init_actor_pets()
@@ -2088,19 +2169,11 @@ bool sim_t::init()
 
   unique_gear::register_target_data_initializers( this );
 
+  double t = util::wall_time();
+
   // Seed RNG
   if ( seed == 0 )
-  {
-    if( deterministic )
-    {
-      seed = 31459;
-    }
-    else
-    {
-      std::random_device rd;
-      seed  = uint64_t(rd()) | (uint64_t(rd()) << 32);
-    }
-  }
+    seed = choose_seed( deterministic );
   _rng = rng::create( rng::parse_type( rng_str ) );
   _rng -> seed( seed + thread_index );
 
@@ -2189,6 +2262,8 @@ bool sim_t::init()
                       .default_value( dbc::find_spell( this, 167188 ) -> effectN ( 1 ).percent() )
                       .add_invalidate( CACHE_VERSATILITY );
 
+  t = init_profile.add( "sim_auras", t );
+
   // Find Already defined target, otherwise create a new one.
   if ( debug )
     out_debug << "Creating Enemies.";
@@ -2252,18 +2327,31 @@ bool sim_t::init()
     }
   }
 
+  t = init_profile.add( "enemies", t );
+
   raid_event_t::init( this );
+  t = init_profile.add( "raid_events", t );
 
   // Initialize actors
   if ( ! init_actors() ) return false;
+  t = util::wall_time();
 
   if ( report_precision < 0 ) report_precision = 2;
 
   simulation_length.reserve( std::min( iterations, 10000 ) );
 
+  if ( static_regen )
+  {
+    for ( const auto& actor : actor_list )
+    {
+      if ( actor -> regen_type == REGEN_DYNAMIC )
+        actor -> regen_type = REGEN_STATIC;
+    }
+  }
+
   for ( const auto& player : player_list )
   {
-    if ( player -> regen_type == REGEN_STATIC )
+    if ( player -> regen_type == REGEN_STATIC && player -> primary_resource() != RESOURCE_NONE )
     {
       requires_regen_event = true;
       break;
@@ -2290,6 +2378,7 @@ bool sim_t::init()
       return false;
     }
   }
+  init_profile.add( "init_finished", t );
 
   initialized = true;
 
@@ -2362,6 +2451,23 @@ bool sim_t::iterate()
   if ( ! init() )
     return false;
 
+  if ( perturbations.empty() )
+    iterate_work();
+  else
+    iterate_perturbations();
+
+  reset();
+
+  iterations = current_iteration + 1;
+
+  return iterations > 0;
+}
+
+// sim_t::iterate_work ======================================================
+
+/// Run iterations until the work queue is empty
+void sim_t::iterate_work()
+{
   progress_bar.init();
 
   do
@@ -2385,12 +2491,248 @@ bool sim_t::iterate()
     util::fprintf( stdout, "%s %s\n", sim_phase_str.c_str(), progress_bar.status.c_str() );
     fflush( stdout );
   }
+}
 
-  reset();
+// sim_t::iterate_perturbations =============================================
 
-  iterations = current_iteration + 1;
+/**
+ * @brief Run every stat perturbation point on this sim in turn
+ *
+ * Each point adds its stats to the players, runs the iterations this sim
+ * would run for a plain simulation and takes them away again, so a plot pays
+ * for setup and init of the actors once instead of once per point. The
+ * scaling metric of every iteration is collected per point in
+ * perturbation_data; the regular collected data of the actors mixes all
+ * points and is not analyzed.
+ */
+void sim_t::iterate_perturbations()
+{
+  int work = work_queue -> size();
+  int completed = 0;
 
-  return iterations > 0;
+  perturbation_data.clear();
+  for ( size_t i = 0; i < perturbations.size(); ++i )
+  {
+    perturbation_data.push_back( std::vector<extended_sample_data_t>() );
+    for ( size_t j = 0; j < actor_list.size(); ++j )
+    {
+      const extended_sample_data_t* second;
+      const extended_sample_data_t* first = scaling_metric_samples( *actor_list[ j ], scaling -> scaling_metric, second );
+      perturbation_data.back().push_back( extended_sample_data_t( first -> name_str, first -> simple ) );
+    }
+  }
+  perturbation_seen.assign( actor_list.size(), std::make_pair( size_t( 0 ), 0.0 ) );
+
+  for ( size_t i = 0; i < perturbations.size() && ! canceled; ++i )
+  {
+    current_perturbation = i;
+    apply_perturbation( perturbations[ i ], 1.0 );
+    if ( ! perturbations[ i ].phase_str.empty() )
+      sim_phase_str = perturbations[ i ].phase_str;
+
+    // Every point starts over like a sim of its own: its first iteration
+    // collects no data, and enemy health converges on the new stats again
+    current_iteration = -1;
+    work_queue -> reset( work );
+
+    iterate_work();
+
+    completed += current_iteration + 1;
+    apply_perturbation( perturbations[ i ], -1.0 );
+  }
+
+  current_iteration = completed - 1;
+}
+
+// sim_t::apply_perturbation ================================================
+
+/// Add ( sign = 1 ) or remove ( sign = -1 ) the stats of a perturbation point
+void sim_t::apply_perturbation( const stat_perturbation_t& point, double sign )
+{
+  for ( size_t i = 0; i < point.stats.size(); ++i )
+  {
+    stat_e stat = point.stats[ i ].first;
+    double value = sign * point.stats[ i ].second;
+
+    // Resources are recomputed from the sim enchant on every player reset
+    enchant.add_stat( stat, value );
+
+    for ( size_t j = 0; j < player_no_pet_list.size(); ++j )
+    {
+      player_t* p = player_no_pet_list[ j ];
+      if ( p -> is_enemy() )
+        continue;
+
+      p -> total_gear.add_stat( stat, value );
+      p -> initial.stats.add_stat( stat, value );
+    }
+  }
+}
+
+// sim_t::sample_perturbation ===============================================
+
+/// Record the scaling metric the actors collected this iteration
+void sim_t::sample_perturbation()
+{
+  std::vector<extended_sample_data_t>& data = perturbation_data[ current_perturbation ];
+
+  for ( size_t i = 0, end = std::min( data.size(), actor_list.size() ); i < end; ++i )
+  {
+    const extended_sample_data_t* second;
+    const extended_sample_data_t* first = scaling_metric_samples( *actor_list[ i ], scaling -> scaling_metric, second );
+
+    std::pair<size_t, double>& seen = perturbation_seen[ i ];
+    size_t count = first -> count();
+    if ( count == seen.first )
+      continue;
+
+    double total = sample_tail_sum( *first, seen.first );
+    if ( second )
+      total += sample_tail_sum( *second, seen.first );
+
+    // Running sums include everything seen so far
+    double sum = first -> simple ? total - seen.second : total;
+
+    data[ i ].add( sum / ( count - seen.first ) );
+    seen.first = count;
+    seen.second = first -> simple ? total : 0;
+  }
+}
+
+// sim_t::can_perturb =======================================================
+
+/// Whether a stat can be plotted by perturbation instead of a sim per point
+bool sim_t::can_perturb( stat_e stat ) const
+{
+  // Weapon damage is set up on the weapons at init
+  if ( stat == STAT_WEAPON_DPS || stat == STAT_WEAPON_OFFHAND_DPS )
+    return false;
+
+  // Death samples are not taken once per iteration
+  return scaling -> scaling_metric != SCALE_METRIC_DEATHS;
+}
+
+// sim_t::verify_perturbation ===============================================
+
+/**
+ * @brief Check a perturbation point against a sim initialized with its stats
+ *
+ * Perturbation only adds the stats to the initial stats of the players, and
+ * relies on player reset to recompute resources. Anything else an actor
+ * derives from its stats during init would keep the unperturbed value, so
+ * the point is compared with a sim of its own that is initialized, but not
+ * run. Initializes this sim.
+ */
+bool sim_t::verify_perturbation( const stat_perturbation_t& point )
+{
+  if ( ! init() )
+    return false;
+
+  std::unique_ptr<sim_t> reference( new sim_t( parent ) );
+  for ( size_t i = 0; i < point.stats.size(); ++i )
+    reference -> enchant.add_stat( point.stats[ i ].first, point.stats[ i ].second );
+
+  if ( ! reference -> init() )
+    return false;
+
+  apply_perturbation( point, 1.0 );
+
+  bool match = true;
+  for ( size_t i = 0; i < player_list.size() && match; ++i )
+  {
+    player_t* p = player_list[ i ];
+    player_t* q = reference -> find_player( p -> name() );
+    if ( ! q )
+    {
+      match = false;
+      break;
+    }
+
+    // Resources as player reset computes them
+    p -> init_resources( true );
+    q -> init_resources( true );
+
+    match = p -> initial.to_string() == q -> initial.to_string();
+    for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX && match; r++ )
+    {
+      double a = p -> resources.initial[ r ], b = q -> resources.initial[ r ];
+      match = std::fabs( a - b ) <= 1e-9 * std::max( 1.0, std::fabs( b ) );
+    }
+
+    if ( ! match && debug )
+      out_debug.printf( "%s differs from a sim initialized with the perturbed stats", p -> name() );
+  }
+
+  apply_perturbation( point, -1.0 );
+  for ( size_t i = 0; i < player_list.size(); ++i )
+    player_list[ i ] -> init_resources( true );
+
+  return match;
+}
+
+// sim_t::perturbation_result ===============================================
+
+/// Scaling metric of a player of the parent sim at a perturbation point
+scaling_metric_data_t sim_t::perturbation_result( size_t point, const player_t& p ) const
+{
+  const player_t* q = nullptr;
+  if ( ! scaling -> scale_over_player.empty() )
+    q = find_player( scaling -> scale_over_player );
+  if ( ! q )
+    q = find_player( p.name() );
+  assert( q );
+
+  // Nothing was run, e.g. when init failed
+  if ( point >= perturbation_data.size() || q -> actor_index >= perturbation_data[ point ].size() )
+    return scaling_metric_data_t( scaling -> scaling_metric, p.name_str, 0, 0 );
+
+  return scaling_metric_data_t( scaling -> scaling_metric, perturbation_data[ point ][ q -> actor_index ] );
+}
+
+
+// sim_t::calibrates_health =================================================
+
+/// Whether execute() runs a health calibration phase
+bool sim_t::calibrates_health() const
+{
+  return health_calibration_iterations > 0 && ! fixed_time && overrides.target_health.size() == 0;
+}
+
+// sim_t::calibrate_health ==================================================
+
+/**
+ * @brief Run the enemy health calibration phase
+ *
+ * Runs health_calibration_iterations iterations on the main sim before any
+ * worker sims are created, so that enemies converge on their initial health
+ * once instead of separately in every thread. The calibration iterations are
+ * not pulled from the work queue and collect no data. Worker sims inherit the
+ * calibrated health when they are created in partition().
+ */
+bool sim_t::calibrate_health()
+{
+  if ( ! init() )
+    return false;
+
+  if ( ! calibrates_health() )
+    return true;
+
+  if ( debug )
+    out_debug.printf( "Calibrating enemy health over %d iterations", health_calibration_iterations );
+
+  calibrating_health = true;
+
+  for ( int i = 0; i < health_calibration_iterations && ! canceled; ++i )
+  {
+    ++current_iteration;
+
+    combat();
+  }
+
+  calibrating_health = false;
+  current_iteration = -1;
+
+  return ! canceled;
 }
 
 /**
@@ -2450,6 +2792,17 @@ void sim_t::merge( sim_t& other_sim )
   }
 
   range::append( iteration_data, other_sim.iteration_data );
+
+  for ( size_t i = 0; i < perturbation_data.size() && i < other_sim.perturbation_data.size(); ++i )
+  {
+    for ( auto & player : actor_list )
+    {
+      player_t* other_p = other_sim.find_player( player -> index );
+      if ( player -> actor_index < perturbation_data[ i ].size() &&
+           other_p -> actor_index < other_sim.perturbation_data[ i ].size() )
+        perturbation_data[ i ][ player -> actor_index ].merge( other_sim.perturbation_data[ i ][ other_p -> actor_index ] );
+    }
+  }
 }
 
 /// merge all sims together
@@ -2460,18 +2813,30 @@ void sim_t::merge()
 
   merge_mutex.unlock();
 
+  // Every child has to finish before any of them is deleted, so an error of
+  // one is only rethrown once all are done
+  std::exception_ptr error;
   for ( size_t i = 0; i < children.size(); i++ )
   {
     sim_t* child = children[ i ];
     if ( child )
     {
-      child -> join();
-      children[ i ] = nullptr;
-      delete child;
+      std::exception_ptr e = child -> worker_task.join();
+      if ( e && ! error )
+        error = e;
     }
   }
 
+  for ( size_t i = 0; i < children.size(); i++ )
+  {
+    delete children[ i ];
+    children[ i ] = nullptr;
+  }
+
   children.clear();
+
+  if ( error )
+    std::rethrow_exception( error );
 }
 
 // sim_t::run ===============================================================
@@ -2504,7 +2869,9 @@ void sim_t::partition()
   // However, when we desire deterministic runs (for debugging) we need to force the
   // sims to each use a specific number of iterations as opposed to using shared pool of work.
 
-  if( deterministic ) 
+  // Perturbation runs restart the work queue at every point, which they
+  // can only do on a work queue of their own.
+  if( deterministic || ! perturbations.empty() )
   {
     work_queue -> init( iterations );
   }
@@ -2524,7 +2891,7 @@ void sim_t::partition()
       remainder--;
     }
 
-    if( deterministic ) 
+    if( deterministic || ! perturbations.empty() )
     {
       child -> work_queue -> init( child -> iterations );
     }
@@ -2537,8 +2904,10 @@ void sim_t::partition()
 
   computer_process::set_priority( process_priority ); // Set main thread priority
 
+  // Every child runs at once, even with more threads than the hardware has
+  thread_pool_t::instance().reserve( children.size() );
   for ( auto & child : children )
-    child -> launch();
+    child -> worker_task = thread_pool_t::instance().submit( [ child ]() { child -> run(); } );
 }
 
 // sim_t::execute ===========================================================
@@ -2548,11 +2917,39 @@ bool sim_t::execute()
   double start_cpu_time  = util::cpu_time();
   double start_wall_time = util::wall_time();
 
-  partition();
-  bool success = iterate();
+  // Worker sims start from the health calibrated by this sim, so they can
+  // only be created once calibration is done. Without calibration they are
+  // launched right away and initialize alongside this sim.
+  bool success = true;
+  if ( calibrates_health() )
+  {
+    success = calibrate_health();
+    if ( success )
+      partition();
+  }
+  else
+    partition();
+
+  if ( success )
+    success = iterate();
   merge(); // Always merge, even in cases of unsuccessful simulation!
+  event_trace.close();
   if( success )
-    analyze();
+  {
+    if ( perturbations.empty() )
+      analyze();
+    else
+    {
+      for ( auto & point : perturbation_data )
+      {
+        for ( auto & data : point )
+        {
+          data.analyze_basics();
+          data.analyze_variance();
+        }
+      }
+    }
+  }
 
   elapsed_cpu  = util::cpu_time()  - start_cpu_time;
   elapsed_time = util::wall_time() - start_wall_time;
@@ -2759,12 +3156,16 @@ void sim_t::create_options()
   add_option( opt_float( "confidence", confidence, 0.0, 1.0 ) );
   add_option( opt_func( "spell_query", parse_spell_query ) );
   add_option( opt_string( "spell_query_xml_output_file", spell_query_xml_output_file_str ) );
+  add_option( opt_bool( "spell_query_index", spell_query_index ) );
   add_option( opt_func( "item_db_source", parse_item_sources ) );
   add_option( opt_func( "proxy", parse_proxy ) );
   add_option( opt_int( "auto_ready_trigger", auto_ready_trigger ) );
   add_option( opt_int( "stat_cache", stat_cache ) );
   add_option( opt_int( "max_aoe_enemies", max_aoe_enemies ) );
   add_option( opt_bool( "optimize_expressions", optimize_expressions ) );
+  add_option( opt_bool( "verify_folded_multipliers", verify_folded_multipliers ) );
+  add_option( opt_bool( "action_sequence_samples", action_sequence_samples ) );
+  add_option( opt_bool( "cooldown_recharge_events", cooldown_recharge_events ) );
   // Raid buff overrides
   add_option( opt_func( "optimal_raid", parse_optimal_raid ) );
   add_option( opt_int( "override.attack_power_multiplier", overrides.attack_power_multiplier ) );
@@ -2810,6 +3211,9 @@ void sim_t::create_options()
   add_option( opt_string( "xml_style", xml_stylesheet_file_str ) );
   add_option( opt_bool( "log", log ) );
   add_option( opt_string( "output", output_file_str ) );
+  add_option( opt_string( "trace_file", event_trace.file_str ) );
+  add_option( opt_string( "trace_seeds", event_trace.seeds_str ) );
+  add_option( opt_string( "trace_condition", event_trace.condition_str ) );
   add_option( opt_bool( "save_raid_summary", save_raid_summary ) );
   add_option( opt_bool( "save_gear_comments", save_gear_comments ) );
   add_option( opt_bool( "buff_uptime_timeline", buff_uptime_timeline ) );
@@ -2823,6 +3227,7 @@ void sim_t::create_options()
   add_option( opt_bool( "override.bloodlust", overrides.bloodlust ) );
   // Regen
   add_option( opt_timespan( "regen_periodicity", regen_periodicity ) );
+  add_option( opt_bool( "static_regen", static_regen ) );
   // RNG
   add_option( opt_string( "rng", rng_str ) );
   add_option( opt_bool( "deterministic", deterministic ) );
@@ -2861,6 +3266,8 @@ void sim_t::create_options()
   add_option( opt_bool( "show_etmi", show_etmi ) );
   add_option( opt_float( "tmi_window_global", tmi_window_global ) );
   add_option( opt_float( "tmi_bin_size", tmi_bin_size ) );
+  add_option( opt_float( "timeline_resolution", timeline_resolution ) );
+  add_option( opt_int( "health_calibration_iterations", health_calibration_iterations ) );
   add_option( opt_bool( "enable_taunts", enable_taunts ) );
   // Character Creation
   add_option( opt_func( "death_knight", parse_player ) );
@@ -2884,6 +3291,7 @@ void sim_t::create_options()
   add_option( opt_func( "armory", parse_armory ) );
   add_option( opt_func( "armory_html", parse_armory ) );
   add_option( opt_func( "guild", parse_guild ) );
+  add_option( opt_int( "import_threads", import_threads ) );
   add_option( opt_func( "wowhead", parse_armory ) );
   add_option( opt_func( "mopdev", parse_armory ) );
   add_option( opt_func( "mophead", parse_armory ) );
@@ -3016,6 +3424,10 @@ void sim_t::setup( sim_control_t* c )
 
   }
 
+  // 0 turns the per-action timelines off
+  if ( timeline_resolution < 0 )
+    throw std::invalid_argument( "timeline_resolution must not be negative" );
+
   if ( player_list.empty() && spell_query == nullptr )
   {
     throw std::runtime_error( "Nothing to sim!" );
@@ -3043,6 +3455,9 @@ void sim_t::setup( sim_control_t* c )
       throw std::runtime_error( s.str() );
     }
   }
+
+  event_trace.setup();
+
   if ( debug_each )
     debug = 1;
 
@@ -3302,6 +3717,210 @@ void sc_timeline_t::adjust( sim_t& sim )
   base_t::adjust( sim.divisor_timeline_cache[ bin_size ] );
 }
 
+// sc_timeline_t::add_rebinned ==============================================
+
+void sc_timeline_t::add_rebinned( const sc_timeline_t& other, size_t max_buckets )
+{
+  if ( other.bin_size == bin_size )
+  {
+    for ( size_t j = 0, j_max = std::min( max_buckets, other.data().size() ); j < j_max; j++ )
+      add( j, other.data()[ j ] );
+    return;
+  }
+
+  // Distribute each source bin over the destination bins it overlaps, proportional to the overlap
+  for ( size_t j = 0, size = other.data().size(); j < size; j++ )
+  {
+    double start = j * other.bin_size;
+    double end = start + other.bin_size;
+
+    for ( size_t k = static_cast<size_t>( start / bin_size ); k < max_buckets && k * bin_size < end; k++ )
+    {
+      double overlap = std::min( end, ( k + 1 ) * bin_size ) - std::max( start, k * bin_size );
+      add( k, other.data()[ j ] * overlap / other.bin_size );
+    }
+  }
+}
+
+// ==========================================================================
+// Health Index
+// ==========================================================================
+
+namespace { // UNNAMED NAMESPACE
+
+// Actors without health never qualify as lowest
+double health_pct( const player_t* p )
+{
+  return p -> resources.max[ RESOURCE_HEALTH ] > 0 ? p -> resources.pct( RESOURCE_HEALTH )
+                                                    : std::numeric_limits<double>::infinity();
+}
+
+double health_missing( const player_t* p )
+{ return p -> resources.max[ RESOURCE_HEALTH ] - p -> resources.current[ RESOURCE_HEALTH ]; }
+
+// Ties go to the actor that comes first in the player lists, as the linear
+// scans used to do
+bool lower_health( const player_t* l, const player_t* r )
+{
+  double lp = health_pct( l ), rp = health_pct( r );
+  return lp < rp || ( lp == rp && l -> actor_index < r -> actor_index );
+}
+
+bool lower_health_last( const player_t* l, const player_t* r )
+{
+  double lp = health_pct( l ), rp = health_pct( r );
+  return lp < rp || ( lp == rp && l -> actor_index > r -> actor_index );
+}
+
+bool more_missing( const player_t* l, const player_t* r )
+{
+  double lm = health_missing( l ), rm = health_missing( r );
+  return lm > rm || ( lm == rm && l -> actor_index < r -> actor_index );
+}
+
+} // UNNAMED NAMESPACE
+
+health_index_t::health_index_t() :
+  active( false ),
+  players( lower_health ), players_last( lower_health_last ),
+  pets( lower_health ), missing( more_missing )
+{ }
+
+// health_index_t::build ====================================================
+
+void health_index_t::build( sim_t& sim )
+{
+  size_t n_actors = sim.actor_list.size();
+  players.clear( n_actors );
+  players_last.clear( n_actors );
+  pets.clear( n_actors );
+  missing.clear( n_actors );
+
+  for ( size_t i = 0; i < sim.player_list.size(); ++i )
+  {
+    player_t* p = sim.player_list[ i ];
+    if ( p -> is_pet() )
+    {
+      pets.insert( p );
+    }
+    else
+    {
+      players.insert( p );
+      players_last.insert( p );
+      missing.insert( p );
+    }
+  }
+
+  active = true;
+}
+
+// health_index_t::update ===================================================
+
+void health_index_t::update( player_t* p )
+{
+  if ( p -> is_pet() )
+  {
+    pets.update( p );
+  }
+  else
+  {
+    players.update( p );
+    players_last.update( p );
+    missing.update( p );
+  }
+}
+
+// health_index_t::heap_t ===================================================
+
+void health_index_t::heap_t::clear( size_t n_actors )
+{
+  heap.clear();
+  position.assign( n_actors, -1 );
+}
+
+void health_index_t::heap_t::insert( player_t* p )
+{
+  heap.push_back( p );
+  position[ p -> actor_index ] = static_cast<int>( heap.size() - 1 );
+  move_up( heap.size() - 1 );
+}
+
+void health_index_t::heap_t::update( player_t* p )
+{
+  if ( p -> actor_index >= position.size() || position[ p -> actor_index ] < 0 )
+    return;
+
+  size_t i = position[ p -> actor_index ];
+  if ( i > 0 && before( p, heap[ ( i - 1 ) / 2 ] ) )
+    move_up( i );
+  else
+    move_down( i );
+}
+
+void health_index_t::heap_t::first( size_t n, std::vector<player_t*>& out ) const
+{
+  // Best-first walk of the heap; only the children of already taken nodes
+  // can be next
+  order_fn_t f = before;
+  const std::vector<player_t*>& h = heap;
+  auto worse = [ f, &h ]( size_t l, size_t r ) { return f( h[ r ], h[ l ] ); };
+
+  std::vector<size_t> candidates;
+  if ( ! heap.empty() )
+    candidates.push_back( 0 );
+
+  while ( out.size() < n && ! candidates.empty() )
+  {
+    std::pop_heap( candidates.begin(), candidates.end(), worse );
+    size_t i = candidates.back();
+    candidates.pop_back();
+
+    out.push_back( heap[ i ] );
+
+    for ( size_t c = 2 * i + 1; c <= 2 * i + 2 && c < heap.size(); ++c )
+    {
+      candidates.push_back( c );
+      std::push_heap( candidates.begin(), candidates.end(), worse );
+    }
+  }
+}
+
+void health_index_t::heap_t::move_up( size_t i )
+{
+  player_t* p = heap[ i ];
+  while ( i > 0 && before( p, heap[ ( i - 1 ) / 2 ] ) )
+  {
+    place( i, heap[ ( i - 1 ) / 2 ] );
+    i = ( i - 1 ) / 2;
+  }
+  place( i, p );
+}
+
+void health_index_t::heap_t::move_down( size_t i )
+{
+  player_t* p = heap[ i ];
+  size_t n = heap.size();
+  while ( true )
+  {
+    size_t c = 2 * i + 1;
+    if ( c >= n )
+      break;
+    if ( c + 1 < n && before( heap[ c + 1 ], heap[ c ] ) )
+      c++;
+    if ( ! before( heap[ c ], p ) )
+      break;
+    place( i, heap[ c ] );
+    i = c;
+  }
+  place( i, p );
+}
+
+void health_index_t::heap_t::place( size_t i, player_t* p )
+{
+  heap[ i ] = p;
+  position[ p -> actor_index ] = static_cast<int>( i );
+}
+
 // FIXME!  Move this to util at some point.
 
 sc_raw_ostream_t& sc_raw_ostream_t::printf( const char* fmt, ... )
@@ -0,0 +1,400 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "simulationcraft.hpp"
+
+namespace { // UNNAMED NAMESPACE
+
+const uint32_t TRACE_VERSION = 1;
+
+// Unconditional traces hand a long iteration to the writer in pieces of
+// roughly this size
+const size_t TRACE_FLUSH_SIZE = 1 << 20;
+
+typedef std::pair<uint32_t, std::vector<char> > trace_chunk_t;
+
+} // UNNAMED NAMESPACE
+
+// ==========================================================================
+// Trace Writer
+// ==========================================================================
+
+struct trace_writer_t
+{
+  io::cfile file;
+  mutex_t mutex;
+  condition_variable_t cv;
+  std::vector<trace_chunk_t> queue;
+  bool done;
+  thread_pool_t::future_t task;
+
+  trace_writer_t( const io::cfile& f ) :
+    file( f ), done( false )
+  { }
+
+  void launch()
+  { task = thread_pool_t::instance().submit( [ this ]() { run(); } ); }
+
+  void push( uint32_t thread_index, std::vector<char>& chunk )
+  {
+    AUTO_LOCK( mutex );
+    queue.push_back( trace_chunk_t( thread_index, std::vector<char>() ) );
+    queue.back().second.swap( chunk );
+    cv.signal();
+  }
+
+  // Writes everything still queued and stops the writer thread
+  void finish()
+  {
+    {
+      AUTO_LOCK( mutex );
+      done = true;
+      cv.signal();
+    }
+    task.wait();
+    file.close();
+  }
+
+private:
+  void run()
+  {
+    std::vector<trace_chunk_t> pending;
+
+    while ( true )
+    {
+      {
+        AUTO_LOCK( mutex );
+        while ( queue.empty() && ! done )
+          cv.wait( mutex );
+
+        if ( queue.empty() )
+          break;
+
+        pending.swap( queue );
+      }
+
+      for ( auto& chunk : pending )
+      {
+        uint32_t header[ 2 ] = { chunk.first, static_cast<uint32_t>( chunk.second.size() ) };
+        fwrite( header, sizeof( header ), 1, file );
+        fwrite( chunk.second.data(), 1, chunk.second.size(), file );
+      }
+      pending.clear();
+    }
+  }
+};
+
+// ==========================================================================
+// Event Trace
+// ==========================================================================
+
+event_trace_t::event_trace_t( sim_t& s ) :
+  active( false ), sim( s ), condition_op( 0 ), condition_value( 0 )
+{ }
+
+event_trace_t::~event_trace_t()
+{
+  close();
+}
+
+// event_trace_t::setup =====================================================
+
+void event_trace_t::setup()
+{
+  seeds.clear();
+  if ( ! seeds_str.empty() )
+  {
+    if ( ! sim.deterministic )
+      throw std::invalid_argument( "trace_seeds requires deterministic=1" );
+
+    std::vector<std::string> splits = util::string_split( seeds_str, ",/" );
+    for ( size_t i = 0; i < splits.size(); i++ )
+    {
+      char* end;
+      uint64_t seed = strtoull( splits[ i ].c_str(), &end, 10 );
+      if ( *end != '\0' )
+        throw std::invalid_argument( "Invalid trace_seeds entry '" + splits[ i ] + "'" );
+      seeds.push_back( seed );
+    }
+  }
+
+  condition_metric.clear();
+  if ( ! condition_str.empty() )
+  {
+    std::string::size_type pos = condition_str.find_first_of( "<>" );
+    if ( pos == std::string::npos || pos == 0 )
+      throw std::invalid_argument( "trace_condition must be <metric><'<' or '>'><value>" );
+
+    condition_metric = condition_str.substr( 0, pos );
+    if ( condition_metric != "dps" && condition_metric != "hps" && condition_metric != "time" )
+      throw std::invalid_argument( "Unknown trace_condition metric '" + condition_metric + "', use dps, hps or time" );
+
+    condition_op = condition_str[ pos ];
+    condition_value = util::str_to_num<double>( condition_str.substr( pos + 1 ) );
+  }
+
+  // Worker threads share the trace file of the main sim
+  if ( ! sim.parent && ! file_str.empty() && ! writer )
+  {
+    io::cfile f( file_str, "wb" );
+    if ( ! f )
+      throw std::runtime_error( "Unable to open trace file '" + file_str + "'" );
+
+    uint32_t header[ 2 ] = { TRACE_VERSION, sizeof( trace_record_t ) };
+    fwrite( "SCTRACE", 8, 1, f );
+    fwrite( header, sizeof( header ), 1, f );
+
+    writer = std::make_shared<trace_writer_t>( f );
+    writer -> launch();
+  }
+}
+
+// event_trace_t::close =====================================================
+
+void event_trace_t::close()
+{
+  if ( ! sim.parent && writer )
+    writer -> finish();
+
+  writer.reset();
+}
+
+// event_trace_t::iteration_begin ===========================================
+
+void event_trace_t::iteration_begin()
+{
+  active = false;
+
+  if ( ! writer || sim.calibrating_health )
+    return;
+
+  if ( ! seeds.empty() && range::find( seeds, sim.seed ) == seeds.end() )
+    return;
+
+  active = true;
+
+  trace_record_t& r = add( TRACE_ITERATION );
+  r.u[ 0 ] = sim.current_iteration;
+  r.u[ 1 ] = static_cast<uint32_t>( sim.seed );
+  r.u[ 2 ] = static_cast<uint32_t>( sim.seed >> 32 );
+}
+
+// event_trace_t::iteration_end =============================================
+
+void event_trace_t::iteration_end()
+{
+  if ( ! active )
+    return;
+
+  active = false;
+
+  if ( ! condition_metric.empty() )
+  {
+    double length = sim.current_time().total_seconds();
+    double value = length;
+    if ( condition_metric == "dps" )
+      value = length > 0 ? sim.iteration_dmg / length : 0;
+    else if ( condition_metric == "hps" )
+      value = length > 0 ? sim.iteration_heal / length : 0;
+
+    bool match = condition_op == '<' ? value < condition_value : value > condition_value;
+    if ( ! match )
+    {
+      // Names interned during the iteration may be used by later ones
+      records.clear();
+      if ( strings.empty() )
+        return;
+    }
+  }
+
+  submit();
+}
+
+// event_trace_t::submit ====================================================
+
+void event_trace_t::submit()
+{
+  std::vector<char> chunk;
+  chunk.swap( strings );
+  chunk.insert( chunk.end(), records.begin(), records.end() );
+  records.clear();
+
+  writer -> push( sim.thread_index, chunk );
+}
+
+// event_trace_t::add =======================================================
+
+trace_record_t& event_trace_t::add( trace_record_e type )
+{
+  if ( condition_metric.empty() && records.size() >= TRACE_FLUSH_SIZE )
+    submit();
+
+  size_t offset = records.size();
+  records.resize( offset + sizeof( trace_record_t ) );
+
+  trace_record_t* r = new ( &records[ offset ] ) trace_record_t();
+  r -> type = type;
+  r -> time = static_cast<uint32_t>( sim.current_time().total_millis() );
+
+  return *r;
+}
+
+// event_trace_t::id ========================================================
+
+uint32_t event_trace_t::id( const char* str )
+{
+  if ( ! str )
+    return 0;
+
+  std::string key( str );
+  auto it = string_ids.find( key );
+  if ( it != string_ids.end() )
+    return it -> second;
+
+  uint32_t new_id = static_cast<uint32_t>( string_ids.size() ) + 1;
+  string_ids[ key ] = new_id;
+
+  trace_record_t r = trace_record_t();
+  r.type = TRACE_STRING;
+  r.u[ 0 ] = new_id;
+  r.u[ 1 ] = static_cast<uint32_t>( strlen( str ) );
+
+  const char* bytes = reinterpret_cast<const char*>( &r );
+  strings.insert( strings.end(), bytes, bytes + sizeof( r ) );
+  strings.insert( strings.end(), str, str + r.u[ 1 ] );
+
+  return new_id;
+}
+
+// event_trace_t::event_add =================================================
+
+void event_trace_t::event_add( const event_t& e )
+{
+  trace_record_t& r = add( TRACE_EVENT_ADD );
+  r.u[ 0 ] = id( e.name() );
+  r.u[ 1 ] = e.id;
+  r.v[ 0 ] = e.time.total_seconds();
+  r.v[ 1 ] = e.reschedule_time.total_seconds();
+}
+
+// event_trace_t::event_reschedule ==========================================
+
+void event_trace_t::event_reschedule( const event_t& e )
+{
+  trace_record_t& r = add( TRACE_EVENT_RESCHEDULE );
+  r.u[ 0 ] = id( e.name() );
+  r.u[ 1 ] = e.id;
+  r.v[ 0 ] = e.time.total_seconds();
+  r.v[ 1 ] = e.reschedule_time.total_seconds();
+}
+
+// event_trace_t::event_execute =============================================
+
+void event_trace_t::event_execute( const event_t& e )
+{
+  add( TRACE_EVENT_EXECUTE ).u[ 0 ] = id( e.name() );
+}
+
+// event_trace_t::event_canceled ============================================
+
+void event_trace_t::event_canceled( const event_t& e )
+{
+  add( TRACE_EVENT_CANCELED ).u[ 0 ] = id( e.name() );
+}
+
+// event_trace_t::schedule_execute ==========================================
+
+void event_trace_t::schedule_execute( const action_t& a )
+{
+  trace_record_t& r = add( TRACE_SCHEDULE_EXECUTE );
+  r.u[ 0 ] = id( a.player -> name() );
+  r.u[ 1 ] = id( a.name() );
+}
+
+// event_trace_t::performs ==================================================
+
+void event_trace_t::performs( const action_t& a )
+{
+  trace_record_t& r = add( TRACE_PERFORMS );
+  r.u[ 0 ] = id( a.player -> name() );
+  r.u[ 1 ] = id( a.name() );
+  r.v[ 0 ] = a.player -> resources.current[ a.player -> primary_resource() ];
+}
+
+// event_trace_t::damage ====================================================
+
+void event_trace_t::damage( action_t& a, const action_state_t& s, dmg_e type )
+{
+  trace_record_t& r = add( type == DMG_DIRECT ? TRACE_DAMAGE : TRACE_TICK_DAMAGE );
+  r.u[ 0 ] = id( a.player -> name() );
+  r.u[ 1 ] = id( a.name() );
+  r.u[ 2 ] = id( s.target -> name() );
+  r.u[ 3 ] = id( util::school_type_string( a.get_school() ) );
+  r.u[ 4 ] = id( util::result_type_string( s.result ) );
+  r.v[ 0 ] = s.result_amount;
+
+  if ( type != DMG_DIRECT )
+  {
+    // Tracing must not create dots the action would not otherwise have
+    const dot_t* dot = a.find_dot( s.target );
+    if ( ! dot )
+      dot = s.target -> find_dot( a.name_str, a.player );
+    if ( dot )
+    {
+      r.v[ 1 ] = dot -> current_tick;
+      r.v[ 2 ] = dot -> num_ticks;
+    }
+  }
+}
+
+// event_trace_t::buff_gain =================================================
+
+void event_trace_t::buff_gain( const buff_t& b )
+{
+  trace_record_t& r = add( TRACE_BUFF_GAIN );
+  r.u[ 0 ] = b.player ? id( b.player -> name() ) : 0;
+  r.u[ 1 ] = id( b.name_str.c_str() );
+  r.n = static_cast<uint16_t>( b.current_stack );
+  r.v[ 0 ] = b.current_value;
+}
+
+// event_trace_t::buff_loss =================================================
+
+void event_trace_t::buff_loss( const buff_t& b )
+{
+  trace_record_t& r = add( TRACE_BUFF_LOSS );
+  r.u[ 0 ] = b.player ? id( b.player -> name() ) : 0;
+  r.u[ 1 ] = id( b.name_str.c_str() );
+}
+
+// event_trace_t::resource_gain =============================================
+
+void event_trace_t::resource_gain( const player_t& p, resource_e resource_type,
+                                   double actual, double amount, const char* source )
+{
+  trace_record_t& r = add( TRACE_RESOURCE_GAIN );
+  r.u[ 0 ] = id( p.name() );
+  r.u[ 1 ] = id( util::resource_type_string( resource_type ) );
+  r.u[ 2 ] = id( source );
+  r.v[ 0 ] = actual;
+  r.v[ 1 ] = amount;
+  r.v[ 2 ] = p.resources.current[ resource_type ];
+  r.v[ 3 ] = p.resources.max[ resource_type ];
+}
+
+// event_trace_t::resource_loss =============================================
+
+void event_trace_t::resource_loss( const player_t& p, resource_e resource_type,
+                                   double actual, double amount )
+{
+  trace_record_t& r = add( TRACE_RESOURCE_LOSS );
+  r.u[ 0 ] = id( p.name() );
+  r.u[ 1 ] = id( util::resource_type_string( resource_type ) );
+  r.v[ 0 ] = actual;
+  r.v[ 1 ] = amount;
+  r.v[ 2 ] = p.resources.current[ resource_type ];
+  r.v[ 3 ] = p.resources.max[ resource_type ];
+  r.f = static_cast<float>( p.health_percentage() );
+}
@@ -82,11 +82,13 @@ struct item_t;
 struct instant_absorb_t;
 struct module_t;
 struct pet_t;
+struct pet_pool_t;
 struct player_t;
 struct plot_t;
 struct proc_t;
 struct reforge_plot_t;
 struct scaling_t;
+struct scaling_metric_data_t;
 struct sim_t;
 struct spell_data_t;
 struct spell_id_t;
@@ -139,6 +141,7 @@ struct sc_timeline_t : public timeline_t
 {
   typedef timeline_t base_t;
   using timeline_t::add;
+  using timeline_t::merge;
   double bin_size;
 
   sc_timeline_t() : timeline_t(), bin_size( 1.0 ) {}
@@ -169,10 +172,23 @@ struct sc_timeline_t : public timeline_t
     }
   }
 
+  // Merge other timeline up to and including the bin of 'current_time'
+  void merge( const sc_timeline_t& other, timespan_t current_time )
+  { base_t::merge( other, static_cast<size_t>( current_time.total_millis() / 1000 / bin_size ) + 1 ); }
+
   void adjust( sim_t& sim );
 
+  // Add other timeline into this one, converting from the bin size of other to ours
+  void add_rebinned( const sc_timeline_t& other, size_t max_buckets );
+
+  // 20 second sliding average, regardless of bin size, of the amount per second
   void build_derivative_timeline( sc_timeline_t& out ) const
-  { base_t::build_sliding_average_timeline( out, 20 ); }
+  {
+    out.set_bin_size( bin_size );
+    base_t::build_sliding_average_timeline( out, std::max( 1u, static_cast<unsigned>( 20.0 / bin_size + 0.5 ) ) );
+    if ( bin_size != 1.0 )
+      out.scale( 1.0 / bin_size );
+  }
 
 private:
   static std::vector<double> build_divisor_timeline( const extended_sample_data_t& simulation_length, double bin_size );
@@ -488,6 +504,8 @@ public:
       reset();
     }
   }
+  void add( timespan_t duration )
+  { iteration_uptime_sum += duration; }
   void datacollection_begin()
   { iteration_uptime_sum = timespan_t::zero(); }
   void datacollection_end( timespan_t t )
@@ -774,6 +792,18 @@ public:
 
   // tmp data collection
 protected:
+  // Stack transitions of the current iteration, reduced into uptime data at datacollection_end
+  struct stack_change_t
+  {
+    timespan_t time;
+    int stack;
+    bool collect_timeline;
+
+    stack_change_t( timespan_t t, int s, bool c ) : time( t ), stack( s ), collect_timeline( c ) {}
+  };
+  std::vector<stack_change_t> stack_changes;
+  void log_stack_change( bool collect_timeline = false );
+  void reduce_stack_changes();
   timespan_t last_start;
   timespan_t last_trigger;
   timespan_t iteration_uptime_sum;
@@ -1431,6 +1461,91 @@ private:
   sc_raw_ostream_t _raw;
 };
 
+/* Binary event trace.
+ *
+ * Traced hooks append fixed-size typed records to a per-sim buffer instead of
+ * formatting log lines. Names are interned per sim and written as string
+ * records ahead of their first use. Each iteration's records are handed to a
+ * background writer shared by the main sim and its worker threads, and
+ * util_scripts/format_trace.py renders them in the text log format.
+ *
+ * File layout, in native byte order: "SCTRACE" and a null, uint32 version,
+ * uint32 record size, then chunks of uint32 thread index, uint32 byte count
+ * and that many bytes of records.
+ */
+enum trace_record_e
+{
+  TRACE_STRING = 1,       // u0=id, u1=length, followed by the characters
+  TRACE_ITERATION,        // u0=iteration, u1/u2=low/high seed bits
+  TRACE_EVENT_ADD,        // u0=event, u1=id, v0=time, v1=reschedule time
+  TRACE_EVENT_RESCHEDULE, // u0=event, u1=id, v0=time, v1=new time
+  TRACE_EVENT_EXECUTE,    // u0=event
+  TRACE_EVENT_CANCELED,   // u0=event
+  TRACE_SCHEDULE_EXECUTE, // u0=actor, u1=action
+  TRACE_PERFORMS,         // u0=actor, u1=action, v0=primary resource
+  TRACE_DAMAGE,           // u0=actor, u1=action, u2=target, u3=school, u4=result, v0=amount
+  TRACE_TICK_DAMAGE,      // as TRACE_DAMAGE, v1=current tick, v2=number of ticks
+  TRACE_BUFF_GAIN,        // u0=actor (0 for raid), u1=buff, n=stack, v0=value
+  TRACE_BUFF_LOSS,        // u0=actor (0 for raid), u1=buff
+  TRACE_RESOURCE_GAIN,    // u0=actor, u1=resource, u2=source, v0=actual, v1=amount, v2=current, v3=max
+  TRACE_RESOURCE_LOSS     // u0=actor, u1=resource, v0=actual, v1=amount, v2=current, v3=max, f=health pct
+};
+
+struct trace_record_t
+{
+  uint8_t  type;
+  uint8_t  unused;
+  uint16_t n;
+  uint32_t time;   // milliseconds
+  uint32_t u[ 5 ]; // string ids and integers
+  float    f;
+  double   v[ 4 ];
+};
+
+struct trace_writer_t;
+
+struct event_trace_t
+{
+  std::string file_str, seeds_str, condition_str;
+  // Records are collected this iteration
+  bool active;
+  std::shared_ptr<trace_writer_t> writer;
+
+  event_trace_t( sim_t& s );
+  ~event_trace_t();
+
+  void setup();
+  void close();
+  void iteration_begin();
+  void iteration_end();
+
+  void event_add( const event_t& );
+  void event_reschedule( const event_t& );
+  void event_execute( const event_t& );
+  void event_canceled( const event_t& );
+  void schedule_execute( const action_t& );
+  void performs( const action_t& );
+  void damage( action_t&, const action_state_t&, dmg_e );
+  void buff_gain( const buff_t& );
+  void buff_loss( const buff_t& );
+  void resource_gain( const player_t&, resource_e, double actual, double amount, const char* source );
+  void resource_loss( const player_t&, resource_e, double actual, double amount );
+private:
+  sim_t& sim;
+  std::vector<uint64_t> seeds;
+  // Iteration condition, "<metric><op><value>"
+  std::string condition_metric;
+  char condition_op;
+  double condition_value;
+  // Interned by content, equal names at different addresses share an id
+  std::unordered_map<std::string, uint32_t> string_ids;
+  std::vector<char> strings, records;
+
+  trace_record_t& add( trace_record_e );
+  uint32_t id( const char* );
+  void submit();
+};
+
 struct sim_report_information_t
 {
   bool charts_generated;
@@ -1488,9 +1603,67 @@ struct event_manager_t
   void merge( event_manager_t& other );
 };
 
+// Health Index =============================================================
+
+// Friendly actors ordered by health, for heal targeting. Built on the first
+// query and then kept up to date by player_t::health_changed(), so sims
+// without heal targeting do not pay for it.
+
+struct health_index_t
+{
+  typedef bool ( *order_fn_t )( const player_t*, const player_t* );
+
+  // Binary heap that tracks the position of every actor in it, so a single
+  // actor can be moved after its health changed
+  struct heap_t
+  {
+    order_fn_t before;
+    std::vector<player_t*> heap;
+    std::vector<int> position; // By actor_index, -1 when not in the heap
+
+    heap_t( order_fn_t f ) : before( f )
+    { }
+
+    player_t* top() const
+    { return heap.empty() ? nullptr : heap.front(); }
+
+    void clear( size_t n_actors );
+    void insert( player_t* p );
+    void update( player_t* p );
+    // First n actors in heap order, in O( n log n )
+    void first( size_t n, std::vector<player_t*>& out ) const;
+  private:
+    void move_up( size_t i );
+    void move_down( size_t i );
+    void place( size_t i, player_t* p );
+  };
+
+  bool active;
+  // Non-pets by health percentage; the second one prefers later actors on ties
+  heap_t players, players_last;
+  heap_t pets;
+  // Non-pets by missing health
+  heap_t missing;
+
+  health_index_t();
+
+  void build( sim_t& sim );
+  void update( player_t* p );
+};
+
+// Stat Perturbation ========================================================
+
+// One point of an in-place stat perturbation run, see
+// sim_t::iterate_perturbations()
+struct stat_perturbation_t
+{
+  std::vector<std::pair<stat_e, double> > stats;
+  std::string phase_str; // progress bar label while the point runs
+};
+
 // Simulation Engine ========================================================
 
-struct sim_t : private sc_thread_t
+struct sim_t : private noncopyable
 {
   event_manager_t event_mgr;
 
@@ -1499,6 +1672,7 @@ struct sim_t : private sc_thread_t
   sim_ostream_t out_log;
   sim_ostream_t out_debug;
   bool debug;
+  event_trace_t event_trace;
 
   // Iteration Controls
   timespan_t max_time, expected_iteration_time;
@@ -1522,6 +1696,7 @@ struct sim_t : private sc_thread_t
   vector_with_callback<player_t*> player_non_sleeping_list;
   vector_with_callback<player_t*> healing_no_pet_list;
   vector_with_callback<player_t*> healing_pet_list;
+  health_index_t health_index;
   player_t*   active_player;
   int         num_players;
   int         num_enemies;
@@ -1541,7 +1716,8 @@ struct sim_t : private sc_thread_t
   double      travel_variance, default_skill;
   timespan_t  reaction_time, regen_periodicity;
   timespan_t  ignite_sampling_delta;
-  bool        fixed_time, optimize_expressions;
+  bool        fixed_time, optimize_expressions, verify_folded_multipliers, action_sequence_samples;
+  bool        cooldown_recharge_events; // Recharge every charged cooldown through events
   int         current_slot;
   int         optimal_raid, log, debug_each;
   int         save_profiles, default_actions;
@@ -1557,7 +1733,13 @@ struct sim_t : private sc_thread_t
   bool        show_etmi;
   double      tmi_window_global;
   double      tmi_bin_size;
+  double      timeline_resolution; // bin size (seconds) of per-action timelines, 0 disables them (and the player damage timelines built from them)
+  int         health_calibration_iterations; // iterations run before measurement to calibrate enemy health
+  bool        calibrating_health;
+  std::vector<double> calibrated_health; // enemy initial health by enemy id, established by the calibration phase
   bool        requires_regen_event;
+  bool        static_regen; // all actors regenerate on the periodic regen event instead of dynamically
+  bool        collect_timelines; // resource/stat timelines are sampled this iteration
 
   // Target options
   double      enemy_death_pct;
@@ -1590,7 +1772,7 @@ struct sim_t : private sc_thread_t
   int active_allies;
 
   std::unordered_map<std::string, std::string> var_map;
-  std::vector<std::unique_ptr<option_t>> options;
+  option_list_t options;
   std::vector<std::string> party_encoding;
   std::vector<std::string> item_db_sources;
 
@@ -1661,6 +1843,13 @@ struct sim_t : private sc_thread_t
   std::unique_ptr<reforge_plot_t> reforge_plot;
   double elapsed_cpu;
   double elapsed_time;
+  // Wall seconds spent in each phase of sim_t::init, in order of first use
+  struct init_profile_t
+  {
+    std::vector<std::pair<std::string, double> > phases;
+    // Adds the time since start to the named phase, returning the current time
+    double add( const std::string& name, double start );
+  } init_profile;
   double     iteration_dmg, priority_iteration_dmg,  iteration_heal, iteration_absorb;
   simple_sample_data_t raid_dps, total_dmg, raid_hps, total_heal, total_absorb, raid_aps;
   extended_sample_data_t simulation_length;
@@ -1723,7 +1912,9 @@ struct sim_t : private sc_thread_t
   // Multi-Threading
   mutex_t merge_mutex;
   int threads;
+  int import_threads; // Concurrent downloads for guild imports
   std::vector<sim_t*> children; // Manual delete!
+  thread_pool_t::future_t worker_task; // run() of a child sim on the thread pool
   int thread_index;
   computer_process::priority_e process_priority;
   struct sim_progress_t
@@ -1741,6 +1932,7 @@ struct sim_t : private sc_thread_t
     int total_work, projected_work, work;
     work_queue_t() : total_work( 0 ), projected_work( 0 ), work( 0 ) {}
     void init( int w )    { AUTO_LOCK(m); total_work = projected_work = w; }
+    void reset( int w )   { AUTO_LOCK(m); total_work = projected_work = w; work = 0; }
     void flush()          { AUTO_LOCK(m); total_work = projected_work = work; }
     void project( int w ) { AUTO_LOCK(m); projected_work = w; assert(w>=work); }
     int  size()           { AUTO_LOCK(m); return total_work; }
@@ -1759,6 +1951,15 @@ struct sim_t : private sc_thread_t
   };
   std::shared_ptr<work_queue_t> work_queue;
 
+  // In-place stat perturbation: every point is run with its stats added to
+  // the players of this sim, instead of in a sim of its own
+  std::vector<stat_perturbation_t> perturbations;
+  size_t current_perturbation;
+  // Scaling metric of every actor, by point and actor index
+  std::vector<std::vector<extended_sample_data_t> > perturbation_data;
+  // Metric samples of every actor accounted for so far, and their total
+  std::vector<std::pair<size_t, double> > perturbation_seen;
+
   // Related Simulations
   mutex_t relatives_mutex;
   std::vector<sim_t*> relatives;
@@ -1766,6 +1967,7 @@ struct sim_t : private sc_thread_t
   // Spell database access
   std::unique_ptr<spell_data_expr_t> spell_query;
   unsigned           spell_query_level;
+  bool               spell_query_index; // Evaluate spell queries on the spell column index
   std::string        spell_query_xml_output_file_str;
 
   mutex_t* pause_mutex; // External pause mutex, instantiated an external entity (in our case the GUI).
@@ -1795,11 +1997,13 @@ struct sim_t : private sc_thread_t
   sim_t( sim_t* parent = nullptr, int thread_index = 0 );
   virtual ~sim_t();
 
-  virtual void run() override;
+  void      run();
   int       main( const std::vector<std::string>& args );
   double    iteration_time_adjust() const;
   double    expected_max_time() const;
   bool      is_canceled() const;
+  bool      calibrates_health() const;
+  bool      calibrate_health();
   void      cancel_iteration();
   void      cancel();
   void      interrupt();
@@ -1821,6 +2025,13 @@ struct sim_t : private sc_thread_t
   void      merge( sim_t& other_sim );
   void      merge();
   bool      iterate();
+  void      iterate_work();
+  void      iterate_perturbations();
+  void      apply_perturbation( const stat_perturbation_t&, double sign );
+  void      sample_perturbation();
+  bool      can_perturb( stat_e ) const;
+  bool      verify_perturbation( const stat_perturbation_t& );
+  scaling_metric_data_t perturbation_result( size_t point, const player_t& ) const;
   void      partition();
   bool      execute();
   void      analyze_error();
@@ -1993,6 +2204,7 @@ public:
   int    dps_plot_iterations;
   double dps_plot_target_error;
   int    dps_plot_debug;
+  int    dps_plot_perturbation;
   stat_e current_plot_stat;
   int    num_plot_stats, remaining_plot_stats, remaining_plot_points;
   bool   dps_plot_positive, dps_plot_negative;
@@ -2024,6 +2236,8 @@ struct reforge_plot_t
   int    reforge_plot_iterations;
   double reforge_plot_target_error;
   int    reforge_plot_debug;
+  int    reforge_plot_adaptive;
+  int    reforge_plot_perturbation;
   int    current_stat_combo;
   int    num_stat_combos;
 
@@ -2040,6 +2254,11 @@ private:
   void write_output_file();
   void create_options();
   void run_reforge_plot( const reforge_plot_run_t& );
+  void run_adaptive_reforge_plot( const reforge_plot_run_t&, const std::vector<std::vector<int>>& stat_mods,
+                                  std::vector<std::vector<std::vector<plot_data_t>>>& results );
+  std::vector<std::vector<plot_data_t>> run_reforge_point( const reforge_plot_run_t&, const std::vector<int>& mods );
+  std::vector<std::vector<std::vector<plot_data_t>>> run_reforge_points( const reforge_plot_run_t&,
+                                                                         const std::vector<std::vector<int>>& mods );
   void debug_plot(  const reforge_plot_run_t&, const std::vector<std::vector<int>>& stat_mods);
 };
 
@@ -2818,9 +3037,16 @@ struct cooldown_t
   timespan_t ready;
   timespan_t reset_react;
   int charges;
-  int current_charge;
-  event_t* recharge_event;
+  int current_charge; // As of the last update_charges()
+  // Charges regenerate analytically: while current_charge < charges, the
+  // current recharge cycle ends at recharge_end and the following ones take
+  // the then current recharge duration of recharge_action
+  timespan_t recharge_end, recharge_duration, recharge_base;
+  action_t* recharge_action;
+  // Only scheduled for actors that wait on a trigger to become ready
   event_t* ready_trigger_event;
+  // Only scheduled when recharge_action has a dynamic cooldown reduction
+  event_t* recharge_event;
   timespan_t last_start, last_charged;
 
   cooldown_t( const std::string& name, player_t& );
@@ -2835,6 +3061,15 @@ struct cooldown_t
 
   void reset_init();
 
+  // Credit the charges that have regenerated up to the current time
+  void update_charges();
+
+  int available_charges()
+  { update_charges(); return current_charge; }
+
+  bool recharging() const
+  { return charges > 1 && current_charge < charges; }
+
   timespan_t remains() const
   { return std::max( timespan_t::zero(), ready - sim.current_time() ); }
 
@@ -2864,6 +3099,9 @@ struct cooldown_t
 
   static timespan_t cooldown_duration( const cooldown_t* cd, const timespan_t& override_duration = timespan_t::min(), const action_t* cooldown_action = nullptr );
 
+  void schedule_ready_trigger();
+  void schedule_recharge_event();
+
 private:
   double recharge_multiplier;
 };
@@ -2882,6 +3120,11 @@ struct player_callbacks_t
   typedef std::array<proc_on_array_t, PROC1_TYPE_MAX> proc_array_t;
 
   proc_array_t procs;
+  // Bumped on every registration, invalidates the per-action dispatch lists
+  unsigned generation;
+
+  player_callbacks_t() : generation( 0 )
+  { }
 
   virtual ~player_callbacks_t()
   { range::sort( all_callbacks ); dispose( all_callbacks.begin(), range::unique( all_callbacks ) ); }
@@ -3167,21 +3410,67 @@ struct player_collected_data_t
 
   resolve_timeline_t resolve_timeline;
 
+  // One entry of a recorded action sequence, expanded for reporting
   struct action_sequence_data_t
   {
     const action_t* action;
     const player_t* target;
-    const timespan_t time;
+    timespan_t time;
     timespan_t wait_time;
     std::vector<std::pair<buff_t*, int> > buff_list;
     std::array<double, RESOURCE_MAX> resource_snapshot;
     std::array<double, RESOURCE_MAX> resource_max_snapshot;
+  };
 
-    action_sequence_data_t( const timespan_t& ts, const timespan_t& wait, const player_t* p );
-    action_sequence_data_t( const action_t* a, const player_t* t, const timespan_t& ts, const player_t* p );
+  // Action sequence recorder. Buffs are stored as ( buff_list index, stack ) pairs and
+  // resources only when they changed since the previous entry. Clearing keeps the
+  // storage, so recording does not allocate once the first iteration has been captured.
+  struct action_sequence_t
+  {
+    struct entry_t
+    {
+      const action_t* action;
+      const player_t* target;
+      timespan_t time;
+      timespan_t wait_time;
+      // One past the last buff / resource of this entry
+      uint32_t buff_end, resource_end;
+    };
+
+    struct resource_entry_t
+    {
+      resource_e resource;
+      double current, max;
+    };
+
+    std::vector<entry_t> entries;
+    std::vector<std::pair<uint16_t, uint16_t> > buffs;
+    std::vector<resource_entry_t> resources;
+    // Resource state as of the last entry
+    std::array<double, RESOURCE_MAX> last_current, last_max;
+    // DPS of the recorded iteration
+    double value;
+
+    action_sequence_t()
+    { clear(); }
+
+    bool empty() const
+    { return entries.empty(); }
+    size_t size() const
+    { return entries.size(); }
+
+    void clear();
+    void add( const action_t* a, const player_t* t, const timespan_t& ts, const timespan_t& wait, const player_t& p );
+    std::vector<action_sequence_data_t> expand( const player_t& p ) const;
   };
-  auto_dispose< std::vector<action_sequence_data_t*> > action_sequence;
-  auto_dispose< std::vector<action_sequence_data_t*> > action_sequence_precombat;
+  // Reported sample: iteration 1, or iteration 0 of single-iteration sims
+  action_sequence_t action_sequence;
+  action_sequence_t action_sequence_precombat;
+  // With action_sequence_samples=1, the lowest, highest and closest to mean DPS iterations
+  action_sequence_t action_sequence_min, action_sequence_max, action_sequence_mean;
+  action_sequence_t action_sequence_recording;
+  double action_sequence_value_sum;
+  unsigned action_sequence_value_count;
 
   // Buffed snapshot_stats (for reporting)
   struct buffed_stats_t
@@ -3204,8 +3493,8 @@ struct player_collected_data_t
   void analyze( const player_t& );
   void collect_data( const player_t& );
   void print_tmi_debug_csv( const sc_timeline_t* nma, const std::vector<double>& weighted_value, const player_t& p );
-  double calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p );
-  double calculate_max_spike_damage( const health_changes_timeline_t& tl, int window );
+  // TMI of the timeline, optionally also returning the max spike damage of the same window
+  double calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p, double* max_spike = nullptr );
   std::ostream& data_str( std::ostream& s ) const;
 };
 
@@ -3409,7 +3698,7 @@ struct player_t : public actor_t
   timespan_t  gcd_ready, base_gcd, started_waiting;
   std::vector<pet_t*> pet_list;
   std::vector<pet_t*> active_pets;
-  std::vector<absorb_buff_t*> absorb_buff_list;
+  std::vector<absorb_buff_t*> absorb_buff_list; // Active absorbs, high priority ones first in absorb_priority order
   std::map<unsigned,instant_absorb_t*> instant_absorb_list;
   resolve::manager_t resolve_manager;
 
@@ -3426,7 +3715,7 @@ struct player_t : public actor_t
   dbc_t       dbc;
 
   // Option Parsing
-  std::vector<std::unique_ptr<option_t>> options;
+  option_list_t options;
 
   // Stat Timelines to Display
   std::vector<stat_e> stat_timelines;
@@ -3594,6 +3883,8 @@ struct player_t : public actor_t
   // Reporting
   std::unique_ptr<player_report_extension_t> report_extension;
   timespan_t iteration_fight_length, arise_time;
+  // Time of the next resource/stat timeline sample, max() when not sampling
+  timespan_t next_timeline_sample;
   timespan_t iteration_waiting_time;
   int iteration_executed_foreground_actions;
   std::array< double, RESOURCE_MAX > iteration_resource_lost, iteration_resource_gained;
@@ -3627,11 +3918,15 @@ struct player_t : public actor_t
   double iteration_heal, iteration_heal_taken, iteration_absorb, iteration_absorb_taken; // temporary accumulators
   double hpr;
   std::vector<unsigned> absorb_priority; // for strict sequence absorbs
+  std::vector<std::pair<unsigned, instant_absorb_t*> > absorb_sequence; // absorb_priority resolved at init
 
   player_processed_report_information_t report_information;
 
   void sequence_add( const action_t* a, const player_t* target, const timespan_t& ts );
   void sequence_add_wait( const timespan_t& amount, const timespan_t& ts );
+  bool sequence_sample_iteration() const;
+  bool sequence_recording() const;
+  void sequence_end();
 
   // Gear
   std::string items_str, meta_gem_str;
@@ -3848,6 +4143,7 @@ struct player_t : public actor_t
   virtual void init_stats();
   virtual void init_distance_targeting();
   virtual void init_absorb_priority();
+  void init_absorb_sequence();
   virtual void register_callbacks();
   // Class specific hook for first-phase initializing special effects. Returns true if the class-specific hook initialized something, false otherwise.
   virtual bool init_special_effect( special_effect_t& /* effect */, unsigned /* spell_id */ ) { return false; }
@@ -4038,6 +4334,12 @@ struct player_t : public actor_t
   virtual void   recalculate_resource_max( resource_e resource_type );
   virtual bool   resource_available( resource_e resource_type, double cost ) const;
   void collect_resource_timeline_information();
+  void sample_timelines();
+  void health_changed()
+  {
+    if ( sim -> health_index.active )
+      sim -> health_index.update( this );
+  }
   virtual resource_e primary_resource() const { return RESOURCE_NONE; }
   virtual role_e   primary_role() const;
   virtual stat_e convert_hybrid_stat( stat_e s ) const { return s; }
@@ -4175,7 +4477,7 @@ struct player_t : public actor_t
   dot_t*      get_dot     ( const std::string& name, player_t* source );
   gain_t*     get_gain    ( const std::string& name );
   proc_t*     get_proc    ( const std::string& name );
-  stats_t*    get_stats   ( const std::string& name, action_t* action = nullptr );
+  virtual stats_t* get_stats( const std::string& name, action_t* action = nullptr );
   benefit_t*  get_benefit ( const std::string& name );
   uptime_t*   get_uptime  ( const std::string& name );
   luxurious_sample_data_t* get_sample_data( const std::string& name );
@@ -4359,7 +4661,7 @@ private:
   }
 public:
 
-  // Static (default), Dynamic, Disabled
+  // Static, Dynamic (default), Disabled
   regen_type_e regen_type;
 
   // Last iteration time regenration occurred. Set at player_t::arise()
@@ -4370,7 +4672,7 @@ public:
   std::vector<bool> regen_caches;
 
   // Flag to indicate if any pets require dynamic regneration. Initialized in
-  // player_t::init().
+  // player_t::init_finished().
   bool dynamic_regen_pets;
 
   // Perform dynamic resource regeneration
@@ -4478,6 +4780,7 @@ struct pet_t : public player_t
   event_t* expiration;
   timespan_t duration;
   bool affects_wod_legendary_ring;
+  pet_pool_t* pool;
 
   struct owner_coefficients_t
   {
@@ -4495,10 +4798,12 @@ public:
   virtual void init_base_stats() override;
   virtual void init_target() override;
   virtual void reset() override;
+  virtual void demise() override;
   virtual void summon( timespan_t duration = timespan_t::zero() );
   virtual void dismiss( bool expired = false );
   virtual void assess_damage( school_e, dmg_e, action_state_t* s ) override;
   virtual void combat_begin() override;
+  virtual stats_t* get_stats( const std::string& name, action_t* action = nullptr ) override;
 
   virtual const char* name() const override { return full_name_str.c_str(); }
   virtual const player_t* get_owner_or_self() const override
@@ -4586,6 +4891,41 @@ public:
   { return active_during_iteration || ( dynamic && sim -> report_pets_separately == 1 ); }
 };
 
+// Pet Pool =================================================================
+
+// Interchangeable instances of one pet, handed out on summon and returned on
+// demise. The first instance is the prototype: it is always handed out first,
+// and unless report_pets_separately is set it owns the stats of the whole pool.
+// Instances that stayed idle during an iteration skip reset and data
+// collection. The pool can only grow while actors are created, as actions
+// cannot be created after sim initialization.
+
+struct pet_pool_t
+{
+  std::vector<pet_t*> pets;
+  std::vector<pet_t*> free_list;
+
+  void add( pet_t* p );
+  void reset();
+
+  // Returns a sleeping instance, or nullptr if all of them are in use
+  pet_t* request()
+  {
+    if ( free_list.empty() )
+      return nullptr;
+
+    pet_t* p = free_list.back();
+    free_list.pop_back();
+    return p;
+  }
+
+  void release( pet_t* p )
+  { free_list.push_back( p ); }
+
+  pet_t* prototype() const
+  { return pets.empty() ? nullptr : pets.front(); }
+};
+
 
 // Gain =====================================================================
 
@@ -4674,6 +5014,9 @@ public:
   std::array<stats_results_t,FULLTYPE_MAX> tick_results_detail;
 
   sc_timeline_t timeline_amount;
+  // Per-iteration buffer, preallocated to the expected fight length and merged into
+  // timeline_amount once at the end of the iteration
+  sc_timeline_t iteration_timeline_amount;
 
   // Reporting only
   std::array<double, RESOURCE_MAX> resource_portion, apr, rpe;
@@ -4909,6 +5252,16 @@ public:
   /// enables/disables proc callback system on the action, like trinkets, enchants, rppm.
   bool callbacks;
 
+  /// Player proc callbacks that this action can trigger, per proc type pair and weapon
+  struct proc_dispatch_t
+  {
+    unsigned key;
+    const weapon_t* weapon;
+    std::vector<action_callback_t*> callbacks;
+  };
+  auto_dispose< std::vector<proc_dispatch_t*> > proc_dispatch;
+  unsigned proc_dispatch_generation;
+
   /// Whether or not the spell uses the yellow attack hit table.
   bool special;
 
@@ -5068,6 +5421,14 @@ public:
 
   /// base damage multiplier (direct and tick damage)
   double base_multiplier;
+
+  /// static_action_multiplier(), static_da_multiplier() and static_ta_multiplier(), evaluated
+  /// once in init_finished()
+  double folded_multiplier, folded_da_multiplier, folded_ta_multiplier;
+  mutable bool folded_multiplier_mismatch;
+  /// Evaluate the static terms on every call instead of using the folded values
+  /// (verify_folded_multipliers)
+  mutable bool unfolded_multipliers;
   double base_hit, base_crit;
   double crit_multiplier, crit_bonus_multiplier, crit_bonus;
   double base_dd_adder;
@@ -5098,6 +5459,15 @@ public:
   /// Static action cooldown duration multiplier
   double base_cooldown_reduction;
 
+  /**
+   * @brief cooldown_reduction() changes during combat, e.g. with haste
+   *
+   * Charged cooldowns started by the action then recharge through an event at
+   * the end of every recharge cycle, so that the next cycle takes its duration
+   * from the state at that time.
+   */
+  bool dynamic_cooldown_reduction;
+
   /**
    * @brief Movement Direction
    * @code
@@ -5395,14 +5765,29 @@ public:
   virtual double radius_() const
   { return radius; }
 
+  /// Multiplier terms that are constant for the whole sim (spell data coefficients, glyphs,
+  /// perks, talent passives, set bonuses). Folded into action_multiplier() at init_finished().
+  virtual double static_action_multiplier() const
+  { return 1.0; }
+
   virtual double action_multiplier() const
-  { return base_multiplier; }
+  { return base_multiplier * ( unfolded_multipliers ? static_action_multiplier() : folded_multiplier ); }
+
+  void verify_folded_multiplier( const action_state_t* s, double folded, bool tick ) const;
+
+  /// Constant direct damage terms, folded into action_da_multiplier() at init_finished().
+  virtual double static_da_multiplier() const
+  { return 1.0; }
+
+  /// Constant tick damage terms, folded into action_ta_multiplier() at init_finished().
+  virtual double static_ta_multiplier() const
+  { return 1.0; }
 
   virtual double action_da_multiplier() const
-  { return base_dd_multiplier; }
+  { return base_dd_multiplier * ( unfolded_multipliers ? static_da_multiplier() : folded_da_multiplier ); }
 
   virtual double action_ta_multiplier() const
-  { return base_td_multiplier; }
+  { return base_td_multiplier * ( unfolded_multipliers ? static_ta_multiplier() : folded_ta_multiplier ); }
 
   virtual double composite_hit() const
   { return base_hit; }
@@ -5579,6 +5964,8 @@ public:
 
   virtual void init_target_cache();
 
+  const std::vector<action_callback_t*>& proc_callbacks( proc_types pt, proc_types2 pt2 );
+
   virtual void reset();
 
   virtual void cancel();
@@ -6389,9 +6776,14 @@ struct action_callback_t : private noncopyable
   bool active;
   bool allow_self_procs;
   bool allow_procs;
+  // Internal cooldown and required weapon of the callback. Checked by the
+  // dispatcher, so callbacks that cannot fire are skipped without a virtual call.
+  cooldown_t* cooldown;
+  weapon_t* weapon;
 
   action_callback_t( player_t* l, bool ap = false, bool asp = false ) :
-    listener( l ), active( true ), allow_self_procs( asp ), allow_procs( ap )
+    listener( l ), active( true ), allow_self_procs( asp ), allow_procs( ap ),
+    cooldown( nullptr ), weapon( nullptr )
   {
     assert( l );
     if ( std::find( l -> callbacks.all_callbacks.begin(), l -> callbacks.all_callbacks.end(), this )
@@ -6416,6 +6808,8 @@ struct action_callback_t : private noncopyable
       if ( cb -> active )
       {
         if ( ! cb -> allow_procs && a && a -> proc ) return;
+        if ( cb -> cooldown && cb -> cooldown -> down() ) continue;
+        if ( cb -> weapon && ( ! a || a -> weapon != cb -> weapon ) ) continue;
         cb -> trigger( a, call_data );
       }
     }
@@ -6453,7 +6847,6 @@ struct dbc_proc_callback_t : public action_callback_t
 
   const item_t& item;
   const special_effect_t& effect;
-  cooldown_t* cooldown;
 
   // Proc trigger types, cached/initialized here from special_effect_t to avoid
   // needless spell data lookups in vast majority of cases
@@ -6463,24 +6856,23 @@ struct dbc_proc_callback_t : public action_callback_t
 
   buff_t* proc_buff;
   action_t* proc_action;
-  weapon_t* weapon;
 
   dbc_proc_callback_t( const item_t& i, const special_effect_t& e ) :
-    action_callback_t( i.player ), item( i ), effect( e ), cooldown( nullptr ),
+    action_callback_t( i.player ), item( i ), effect( e ),
     proc_chance( 0 ), ppm( 0 ),
-    proc_buff( nullptr ), proc_action( nullptr ), weapon( nullptr )
+    proc_buff( nullptr ), proc_action( nullptr )
   { }
 
   dbc_proc_callback_t( const item_t* i, const special_effect_t& e ) :
-    action_callback_t( i -> player ), item( *i ), effect( e ), cooldown( nullptr ),
+    action_callback_t( i -> player ), item( *i ), effect( e ),
     proc_chance( 0 ), ppm( 0 ),
-    proc_buff( nullptr ), proc_action( nullptr ), weapon( nullptr )
+    proc_buff( nullptr ), proc_action( nullptr )
   { }
 
   dbc_proc_callback_t( player_t* p, const special_effect_t& e ) :
-    action_callback_t( p ), item( default_item_ ), effect( e ), cooldown( nullptr ),
+    action_callback_t( p ), item( default_item_ ), effect( e ),
     proc_chance( 0 ), ppm( 0 ),
-    proc_buff( nullptr ), proc_action( nullptr ), weapon( nullptr )
+    proc_buff( nullptr ), proc_action( nullptr )
   { }
 
   virtual void initialize() override;
@@ -7146,6 +7538,14 @@ inline buff_creator_t::operator debuff_t* () const
 inline bool player_t::is_my_pet( player_t* t ) const
 { return t -> is_pet() && t -> cast_pet() -> owner == this; }
 
+// Timeline samples are taken lazily: every whole second since the last
+// sample gets the values in effect before a resource or stat changes.
+inline void player_t::sample_timelines()
+{
+  if ( next_timeline_sample <= sim -> current_time() )
+    collect_resource_timeline_information();
+}
+
 inline void player_t::do_dynamic_regen()
 {
   if ( sim -> current_time() == last_regen )
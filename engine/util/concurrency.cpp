@@ -7,7 +7,12 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <chrono>
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <vector>
 
 // C++11 STL multi-threading hook-ups
 
@@ -30,6 +35,24 @@ public:
   { return m.native_handle(); }
 };
 
+class condition_variable_t::native_t : private nonmoveable
+{
+private:
+  std::condition_variable_any cv;
+public:
+  native_t() :
+    cv() {}
+
+  void wait( mutex_t& m )
+  { cv.wait( m ); }
+
+  void signal()
+  { cv.notify_one(); }
+
+  void broadcast()
+  { cv.notify_all(); }
+};
+
 class sc_thread_t::native_t
 {
 private:
@@ -84,6 +107,25 @@ void mutex_t::lock()
 void mutex_t::unlock()
 { native_handle -> unlock(); }
 
+condition_variable_t::condition_variable_t() :
+    native_handle( new native_t() )
+{
+}
+
+condition_variable_t::~condition_variable_t()
+{
+  // Keep in .cpp file so that std::unique_ptr deleter can see defined native_t class
+}
+
+void condition_variable_t::wait( mutex_t& m )
+{ native_handle -> wait( m ); }
+
+void condition_variable_t::signal()
+{ native_handle -> signal(); }
+
+void condition_variable_t::broadcast()
+{ native_handle -> broadcast(); }
+
 sc_thread_t::sc_thread_t() : native_handle( new native_t() )
 {}
 
@@ -124,6 +166,208 @@ void sc_thread_t::sleep_seconds( double t )
 unsigned sc_thread_t::cpu_thread_count()
 { return native_t::cpu_thread_count(); }
 
+// ==========================================================================
+// Thread Pool
+// ==========================================================================
+
+struct thread_pool_t::future_t::state_t
+{
+  std::mutex m;
+  std::condition_variable finished_cv;
+  bool finished;
+  std::exception_ptr error;
+
+  state_t() : finished( false ) {}
+};
+
+class thread_pool_t::native_t
+{
+public:
+  typedef std::pair<std::function<void()>, std::shared_ptr<future_t::state_t> > task_t;
+
+  static void execute( task_t& task )
+  {
+    std::exception_ptr error;
+    try
+    {
+      task.first();
+    }
+    catch ( ... )
+    {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> state_lock( task.second -> m );
+      task.second -> finished = true;
+      task.second -> error = error;
+    }
+    task.second -> finished_cv.notify_all();
+  }
+private:
+  std::mutex m;
+  std::condition_variable work_cv;
+  std::deque<task_t> queue;
+  std::vector<std::thread> workers;
+  size_t idle;
+  size_t max_workers;
+  bool stopping;
+
+  void work()
+  {
+    std::unique_lock<std::mutex> lock( m );
+
+    while ( true )
+    {
+      ++idle;
+      work_cv.wait( lock, [ this ]() { return stopping || ! queue.empty(); } );
+      --idle;
+
+      if ( queue.empty() )
+        return;
+
+      task_t task = std::move( queue.front() );
+      queue.pop_front();
+      lock.unlock();
+
+      execute( task );
+
+      lock.lock();
+    }
+  }
+public:
+  native_t() :
+    idle( 0 ),
+    max_workers( std::max( std::thread::hardware_concurrency(), 1u ) ),
+    stopping( false )
+  { }
+
+  ~native_t()
+  {
+    {
+      std::lock_guard<std::mutex> lock( m );
+      stopping = true;
+    }
+    work_cv.notify_all();
+
+    for ( auto& worker : workers )
+      worker.join();
+  }
+
+  future_t submit( std::function<void()> f )
+  {
+    auto state = std::make_shared<future_t::state_t>();
+
+    {
+      std::lock_guard<std::mutex> lock( m );
+      queue.push_back( task_t( std::move( f ), state ) );
+
+      if ( queue.size() > idle && workers.size() < max_workers )
+        workers.push_back( std::thread( &native_t::work, this ) );
+    }
+    work_cv.notify_one();
+
+    return future_t( state );
+  }
+
+  void reserve( size_t n )
+  {
+    std::lock_guard<std::mutex> lock( m );
+    max_workers = std::max( max_workers, n );
+  }
+
+  // Remove the task of state s from the queue, if no worker has started it
+  bool take( const std::shared_ptr<future_t::state_t>& s, task_t& task )
+  {
+    std::lock_guard<std::mutex> lock( m );
+
+    for ( auto it = queue.begin(); it != queue.end(); ++it )
+    {
+      if ( it -> second == s )
+      {
+        task = std::move( *it );
+        queue.erase( it );
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+thread_pool_t::thread_pool_t() :
+  native_handle( new native_t() )
+{ }
+
+thread_pool_t::~thread_pool_t()
+{
+  // Keep in .cpp file so that std::unique_ptr deleter can see defined native_t class
+}
+
+/**
+ * @brief The thread pool of the process, created on first use.
+ */
+thread_pool_t& thread_pool_t::instance()
+{
+  static thread_pool_t pool;
+  return pool;
+}
+
+/**
+ * @brief Run a task on a worker thread.
+ * @return future to wait for the task with
+ */
+thread_pool_t::future_t thread_pool_t::submit( std::function<void()> task )
+{
+  return native_handle -> submit( std::move( task ) );
+}
+
+/**
+ * @brief Allow at least n tasks to run concurrently.
+ *
+ * The pool never shrinks below the hardware thread count.
+ */
+void thread_pool_t::reserve( size_t n )
+{
+  native_handle -> reserve( n );
+}
+
+/**
+ * @brief Wait for the task to finish.
+ *
+ * A task no worker has started yet runs on the calling thread. Returns at
+ * once for a default constructed future.
+ *
+ * @return exception that escaped the task, if any
+ */
+std::exception_ptr thread_pool_t::future_t::join()
+{
+  if ( ! state )
+    return std::exception_ptr();
+
+  native_t::task_t task;
+  if ( thread_pool_t::instance().native_handle -> take( state, task ) )
+    native_t::execute( task );
+
+  std::unique_lock<std::mutex> lock( state -> m );
+  state -> finished_cv.wait( lock, [ this ]() { return state -> finished; } );
+
+  return state -> error;
+}
+
+/**
+ * @brief Wait for the task to finish.
+ *
+ * Rethrows an exception that escaped the task.
+ */
+void thread_pool_t::future_t::wait()
+{
+  std::exception_ptr error = join();
+  if ( error )
+    std::rethrow_exception( error );
+}
+
+
 
 
 
@@ -7,12 +7,15 @@
  * mutex
  * thread
  * condition variable
+ * thread pool
  */
 
 #pragma once
 
 #include "config.hpp"
 #include "generic.hpp"
+#include <exception>
+#include <functional>
 #include <memory>
 
 
@@ -30,6 +33,22 @@ public:
   void unlock();
 };
 
+class condition_variable_t : private noncopyable
+{
+private:
+  class native_t;
+  std::unique_ptr<native_t> native_handle;
+
+public:
+  condition_variable_t();
+  ~condition_variable_t();
+
+  // Release the locked mutex until signaled, then lock it again
+  void wait( mutex_t& );
+  void signal();
+  void broadcast();
+};
+
 class sc_thread_t : private noncopyable
 {
 private:
@@ -57,6 +76,47 @@ public:
 
 #define AUTO_LOCK( m ) auto_lock_t auto_lock( m );
 
+/* Process-wide pool of persistent worker threads. A submitted task starts
+ * on an idle worker, or on a new one while the pool is below its size: the
+ * hardware thread count, or more if a caller reserves it. Beyond that tasks
+ * queue. Waiting on a task that has not started runs it on the waiting
+ * thread, so tasks may wait on each other even when the pool is full.
+ * Workers are kept for the lifetime of the process and reused by later
+ * tasks.
+ */
+class thread_pool_t : private noncopyable
+{
+public:
+  class future_t
+  {
+  public:
+    struct state_t;
+
+    future_t() {}
+    explicit future_t( const std::shared_ptr<state_t>& s ) : state( s ) {}
+
+    // Wait for the task to finish, rethrowing an exception that escaped it
+    void wait();
+    // Wait for the task to finish, returning an exception that escaped it
+    std::exception_ptr join();
+    bool valid() const { return state != nullptr; }
+  private:
+    std::shared_ptr<state_t> state;
+  };
+
+  static thread_pool_t& instance();
+
+  future_t submit( std::function<void()> task );
+  // Let the pool grow to at least n concurrently running tasks
+  void reserve( size_t n );
+private:
+  class native_t;
+  std::unique_ptr<native_t> native_handle;
+
+  thread_pool_t();
+  ~thread_pool_t();
+};
+
 namespace computer_process {
 
 enum priority_e {
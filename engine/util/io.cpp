@@ -13,6 +13,11 @@
 #ifdef SC_WINDOWS
 #include <windows.h>
 #include <shellapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 namespace io { // ===========================================================
@@ -238,6 +243,117 @@ utf8_args::utf8_args( int argc, char** argv ) :
   std::vector<std::string>( argv + 1, argv + argc ) {}
 #endif
 
+// mapped_file_t ============================================================
+
+#ifdef SC_WINDOWS
+mapped_file_t::mapped_file_t() :
+  view( 0 ), length( 0 ), file_handle( INVALID_HANDLE_VALUE ), mapping_handle( 0 )
+{ }
+#else
+mapped_file_t::mapped_file_t() :
+  view( 0 ), length( 0 )
+{ }
+#endif
+
+mapped_file_t::~mapped_file_t()
+{ close(); }
+
+#ifdef SC_WINDOWS
+bool mapped_file_t::open( const std::string& filename )
+{
+  close();
+
+  file_handle = CreateFileW( widen( filename ).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+  if ( file_handle == INVALID_HANDLE_VALUE )
+    return false;
+
+  LARGE_INTEGER file_size;
+  if ( ! GetFileSizeEx( file_handle, &file_size ) || file_size.QuadPart == 0 )
+  {
+    close();
+    return false;
+  }
+
+  mapping_handle = CreateFileMappingW( file_handle, 0, PAGE_READONLY, 0, 0, 0 );
+  if ( ! mapping_handle )
+  {
+    close();
+    return false;
+  }
+
+  view = MapViewOfFile( mapping_handle, FILE_MAP_READ, 0, 0, 0 );
+  if ( ! view )
+  {
+    close();
+    return false;
+  }
+
+  length = static_cast<std::size_t>( file_size.QuadPart );
+  return true;
+}
+
+void mapped_file_t::close()
+{
+  if ( view )
+    UnmapViewOfFile( view );
+  if ( mapping_handle )
+    CloseHandle( mapping_handle );
+  if ( file_handle != INVALID_HANDLE_VALUE )
+    CloseHandle( file_handle );
+
+  view = 0;
+  length = 0;
+  mapping_handle = 0;
+  file_handle = INVALID_HANDLE_VALUE;
+}
+#else
+bool mapped_file_t::open( const std::string& filename )
+{
+  close();
+
+  int fd = ::open( filename.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    return false;
+
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || st.st_size <= 0 )
+  {
+    ::close( fd );
+    return false;
+  }
+
+  void* p = mmap( 0, static_cast<std::size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+  // The mapping keeps its own reference to the file
+  ::close( fd );
+  if ( p == MAP_FAILED )
+    return false;
+
+  view = p;
+  length = static_cast<std::size_t>( st.st_size );
+  return true;
+}
+
+void mapped_file_t::close()
+{
+  if ( view )
+    munmap( view, length );
+
+  view = 0;
+  length = 0;
+}
+#endif
+
+void mapped_file_t::swap( mapped_file_t& other )
+{
+  std::swap( view, other.view );
+  std::swap( length, other.length );
+#ifdef SC_WINDOWS
+  std::swap( file_handle, other.file_handle );
+  std::swap( mapping_handle, other.mapping_handle );
+#endif
+}
+
 /* Collects each character in the file until EOF
  * and returns it as a string
  */
@@ -75,6 +75,33 @@ public:
   bool open( const std::string& filename, const std::vector<std::string>& prefix, openmode mode = in );
 };
 
+// Read-only view of a file mapped into memory. The pages are shared with the
+// page cache (and other processes mapping the same file).
+class mapped_file_t
+{
+  void* view;
+  std::size_t length;
+#ifdef SC_WINDOWS
+  void* file_handle;
+  void* mapping_handle;
+#endif
+
+  mapped_file_t( const mapped_file_t& ); // = delete
+  mapped_file_t& operator=( const mapped_file_t& ); // = delete
+
+public:
+  mapped_file_t();
+  ~mapped_file_t();
+
+  bool open( const std::string& filename );
+  void close();
+  void swap( mapped_file_t& other );
+
+  bool is_open() const { return view != 0; }
+  const char* data() const { return static_cast<const char*>( view ); }
+  std::size_t size() const { return length; }
+};
+
 class utf8_args : public std::vector<std::string>
 {
 public:
@@ -102,7 +102,7 @@ public:
     {
       _data.resize( index + 1 );
     }
-    _data.at( index ) += value;
+    _data[ index ] += value;
   }
 
   // Adjust timeline by dividing through divisor timeline
@@ -116,6 +116,13 @@ public:
     }
   }
 
+  // Multiply every entry by 'factor'
+  void scale( double factor )
+  {
+    for ( size_t j = 0, size = _data.size(); j < size; j++ )
+      _data[ j ] *= factor;
+  }
+
   double mean() const
   { 
     if ( data().size() == 0 )
@@ -144,6 +151,18 @@ public:
       _data.insert( _data.end(), other.data().begin() + _data.size(), other.data().end() );
   }
 
+  // Merge the first 'length' entries of other timeline, extending this timeline to 'length' if
+  // necessary. Entries of other beyond 'length' are ignored, which allows other to be a
+  // preallocated buffer that is larger than the range actually used.
+  void merge( const timeline_t& other, size_t length )
+  {
+    if ( _data.size() < length )
+      _data.resize( length );
+
+    for ( size_t j = 0, num_buckets = std::min( length, other.data().size() ); j < num_buckets; ++j )
+      _data[ j ] += other.data()[ j ];
+  }
+
   void build_sliding_average_timeline( timeline_t& out, unsigned window ) const
   {
     out._data.reserve( data().size() );
@@ -20,3 +20,7 @@ load test_helper
   [ "${status}" -eq 0 ]
 }
 
+@test "Raid damage and heal events" {
+  sim threads=2 raid_events+=/damage,cooldown=5,amount=20000,type=shadow raid_events+=/heal,cooldown=7,amount=20000
+  [ "${status}" -eq 0 ]
+}
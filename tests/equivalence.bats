@@ -0,0 +1,136 @@
+load test_helper
+
+# Runs the profile with the given options and keeps the per-actor DPS lines of
+# the report in ${dps}
+function dps_sim() {
+  sim threads=1 deterministic=1 $@
+  dps="$(echo "${output}" | grep "DPS: ")"
+}
+
+# Succeeds if every number in $1 is within the relative tolerance $3 of the
+# matching number in $2
+function agree() {
+  awk -v a="$1" -v b="$2" -v tol="$3" 'BEGIN {
+    n = split(a, x, /[^0-9.]+/)
+    if (n != split(b, y, /[^0-9.]+/)) exit 1
+    for (i = 1; i <= n; i++)
+      if (x[i] - y[i] > tol * y[i] || y[i] - x[i] > tol * y[i]) exit 1
+  }'
+}
+
+# Runs a spell query on the spell column index and on the id list operators,
+# and compares the printed results
+function query_sim() {
+  sim spell_query="$1"
+  [ "${status}" -eq 0 ]
+  expected="${output}"
+  sim spell_query="$1" spell_query_index=0
+  [ "${status}" -eq 0 ]
+  [ "${output}" = "${expected}" ]
+}
+
+@test "Charged cooldowns recharge the same without recharge events" {
+  dps_sim cooldown_recharge_events=1
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="${dps}"
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ "${dps}" = "${expected}" ]
+}
+
+@test "Spell queries match without the spell column index" {
+  query_sim "spell.class=mage&spell.school=fire"
+  query_sim "spell.class=warrior|spell.class=priest"
+  query_sim "spell.class!=paladin&spell.attribute=4"
+  query_sim "spell.effect.type=6&spell.class=druid"
+  query_sim "spell.effect.base_value>1000&spell.class=hunter"
+  query_sim "spell.name~strike&spell.class=rogue"
+  query_sim "spell.name!~shot&spell.class=hunter"
+  query_sim "spell.class=shaman-spell.school=nature"
+}
+
+@test "Timeline resolution does not change results" {
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="${dps}"
+  dps_sim timeline_resolution=0
+  [ "${status}" -eq 0 ]
+  [ "${dps}" = "${expected}" ]
+  dps_sim timeline_resolution=2.5
+  [ "${status}" -eq 0 ]
+  [ "${dps}" = "${expected}" ]
+}
+
+@test "Event tracing does not change results" {
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="${dps}"
+  dps_sim trace_file="${BATS_TMPDIR}/equivalence_trace.bin"
+  [ "${status}" -eq 0 ]
+  [ "${dps}" = "${expected}" ]
+}
+
+@test "Folded action multipliers match the unfolded multipliers" {
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="${dps}"
+  dps_sim verify_folded_multipliers=1
+  [ "${status}" -eq 0 ]
+  [[ ! "${output}" =~ "does not match the unfolded multiplier" ]]
+  [ "${dps}" = "${expected}" ]
+}
+
+@test "Action sequence samples do not change results" {
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="${dps}"
+  dps_sim action_sequence_samples=1
+  [ "${status}" -eq 0 ]
+  [ "${dps}" = "${expected}" ]
+}
+
+# Dynamic regeneration does not take the same regen steps as the periodic
+# regen event, so only agreement within the noise is required
+@test "Dynamic regeneration agrees with static regeneration" {
+  dps_sim static_regen=1
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  expected="$(echo "${dps}" | awk '{ print $2 }')"
+  dps_sim
+  [ "${status}" -eq 0 ]
+  agree "$(echo "${dps}" | awk '{ print $2 }')" "${expected}" 0.05
+}
+
+# In-place perturbation runs every plot point in one sim, so the points see
+# different random numbers than a sim per point
+@test "DPS plot points agree with and without in-place stat perturbation" {
+  sim threads=1 deterministic=1 dps_plot_stat=crit,haste dps_plot_points=4 dps_plot_iterations=100
+  [ "${status}" -eq 0 ]
+  expected="$(echo "${output}" | grep "DPS(")"
+  [ -n "${expected}" ]
+  sim threads=1 deterministic=1 dps_plot_stat=crit,haste dps_plot_points=4 dps_plot_iterations=100 dps_plot_perturbation=1
+  [ "${status}" -eq 0 ]
+  [[ ! "${output}" =~ "during init" ]]
+  agree "$(echo "${output}" | grep "DPS(")" "${expected}" 0.05
+}
+
+# Compares against a build without the change under test, given as
+# SIMC_BASELINE_CLI_PATH. Changes without a switch of their own are checked
+# this way.
+@test "Results agree with a baseline build" {
+  if [ -z "${SIMC_BASELINE_CLI_PATH}" ]; then
+    skip "SIMC_BASELINE_CLI_PATH is not set"
+  fi
+  dps_sim
+  [ "${status}" -eq 0 ]
+  [ -n "${dps}" ]
+  current="$(echo "${dps}" | awk '{ print $2 }')"
+  SIMC_CLI_PATH="${SIMC_BASELINE_CLI_PATH}" dps_sim
+  [ "${status}" -eq 0 ]
+  agree "${current}" "$(echo "${dps}" | awk '{ print $2 }')" 0.05
+}
@@ -0,0 +1,18 @@
+load test_helper
+
+@test "DPS plot" {
+  sim threads=2 dps_plot_stat=crit,haste dps_plot_points=4 dps_plot_iterations=20
+  [ "${status}" -eq 0 ]
+}
+
+@test "DPS plot with in-place stat perturbation" {
+  sim threads=2 dps_plot_stat=crit,haste dps_plot_points=4 dps_plot_iterations=20 dps_plot_perturbation=1
+  [ "${status}" -eq 0 ]
+  [[ ! "${output}" =~ "during init" ]]
+}
+
+@test "Reforge plot with in-place stat perturbation" {
+  sim threads=2 reforge_plot_stat=crit,haste reforge_plot_amount=200 reforge_plot_step=100 reforge_plot_iterations=20 reforge_plot_perturbation=1
+  [ "${status}" -eq 0 ]
+  [[ ! "${output}" =~ "during init" ]]
+}
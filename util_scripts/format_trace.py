@@ -0,0 +1,114 @@
+#!/usr/bin/python
+# Renders a binary event trace written with trace_file=<file> in the text log
+# format. Record layout and types mirror trace_record_t and trace_record_e in
+# engine/simulationcraft.hpp. Traces are written in native byte order, which
+# is assumed to be little-endian here.
+#
+# Usage: format_trace.py trace.bin [output.txt]
+
+import struct
+import sys
+
+TRACE_STRING = 1
+TRACE_ITERATION = 2
+TRACE_EVENT_ADD = 3
+TRACE_EVENT_RESCHEDULE = 4
+TRACE_EVENT_EXECUTE = 5
+TRACE_EVENT_CANCELED = 6
+TRACE_SCHEDULE_EXECUTE = 7
+TRACE_PERFORMS = 8
+TRACE_DAMAGE = 9
+TRACE_TICK_DAMAGE = 10
+TRACE_BUFF_GAIN = 11
+TRACE_BUFF_LOSS = 12
+TRACE_RESOURCE_GAIN = 13
+TRACE_RESOURCE_LOSS = 14
+
+RECORD = struct.Struct("<BBHI5If4d")
+HEADER = struct.Struct("<8sII")
+CHUNK = struct.Struct("<II")
+
+
+def format_record(strings, type, n, u, f, v):
+    s = lambda i: strings.get(u[i], "unknown")
+    actor = lambda: s(0) if u[0] else "Raid"
+
+    if type == TRACE_EVENT_ADD:
+        return "Add Event: %s time=%.4f rs-time=%.4f id=%d" % (s(0), v[0], v[1], u[1])
+    if type == TRACE_EVENT_RESCHEDULE:
+        return "Rescheduling event %s (%d) from %.2f to %.2f" % (s(0), u[1], v[0], v[1])
+    if type == TRACE_EVENT_EXECUTE:
+        return "Executing event: %s" % s(0)
+    if type == TRACE_EVENT_CANCELED:
+        return "Canceled event: %s" % s(0)
+    if type == TRACE_SCHEDULE_EXECUTE:
+        return "%s schedules execute for %s" % (s(0), s(1))
+    if type == TRACE_PERFORMS:
+        return "%s performs %s (%.0f)" % (s(0), s(1), v[0])
+    if type == TRACE_DAMAGE:
+        return "%s %s hits %s for %.0f %s damage (%s)" % (s(0), s(1), s(2), v[0], s(3), s(4))
+    if type == TRACE_TICK_DAMAGE:
+        return "%s %s ticks (%d of %d) %s for %.0f %s damage (%s)" % (
+            s(0), s(1), v[1], v[2], s(2), v[0], s(3), s(4))
+    if type == TRACE_BUFF_GAIN:
+        return "%s gains %s_%d ( value=%.2f )" % (actor(), s(1), n, v[0])
+    if type == TRACE_BUFF_LOSS:
+        return "%s loses %s" % (actor(), s(1))
+    if type == TRACE_RESOURCE_GAIN:
+        return "%s gains %.2f (%.2f) %s from %s (%.2f/%.2f)" % (s(0), v[0], v[1], s(1), s(2), v[2], v[3])
+    if type == TRACE_RESOURCE_LOSS:
+        return "Player %s loses %.2f (%.2f) %s. health pct: %.2f (%.0f/%.0f)" % (
+            s(0), v[0], v[1], s(1), f, v[2], v[3])
+    return None
+
+
+def format_chunk(data, strings, out):
+    offset = 0
+    while offset < len(data):
+        type, _, n, time, u0, u1, u2, u3, u4, f, v0, v1, v2, v3 = RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+        u = (u0, u1, u2, u3, u4)
+        v = (v0, v1, v2, v3)
+
+        if type == TRACE_STRING:
+            strings[u0] = data[offset:offset + u1].decode("utf-8", "replace")
+            offset += u1
+        elif type == TRACE_ITERATION:
+            out.write("------ Iteration #%i ------ (seed=%d)\n" % (u0 + 1, u1 | (u2 << 32)))
+        else:
+            line = format_record(strings, type, n, u, f, v)
+            if line is not None:
+                out.write("%.3f %s\n" % (time / 1000.0, line))
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("Usage: %s trace.bin [output.txt]\n" % sys.argv[0])
+        return 1
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    magic, version, record_size = HEADER.unpack_from(data, 0)
+    if magic != b"SCTRACE\0" or version != 1 or record_size != RECORD.size:
+        sys.stderr.write("%s is not a supported trace file\n" % sys.argv[1])
+        return 1
+
+    out = open(sys.argv[2], "w") if len(sys.argv) > 2 else sys.stdout
+
+    # String ids are local to the thread that wrote them
+    strings = {}
+    offset = HEADER.size
+    while offset + CHUNK.size <= len(data):
+        thread_index, size = CHUNK.unpack_from(data, offset)
+        offset += CHUNK.size
+        format_chunk(data[offset:offset + size], strings.setdefault(thread_index, {}), out)
+        offset += size
+
+    if out is not sys.stdout:
+        out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())